@@ -80,4 +80,38 @@ FetchContent_Declare(
     GIT_TAG v3.11.3
 )
 
-FetchContent_MakeAvailable(nlohmann_json_content)
\ No newline at end of file
+FetchContent_MakeAvailable(nlohmann_json_content)
+
+# =====================
+# Google Benchmark (nodewatcher_bench only)
+# =====================
+if(NODEWATCHER_BUILD_BENCH)
+  set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL "" FORCE)
+  set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL "" FORCE)
+  set(BENCHMARK_ENABLE_INSTALL OFF CACHE BOOL "" FORCE)
+
+  FetchContent_Declare(
+    benchmark_content
+    GIT_REPOSITORY https://github.com/google/benchmark.git
+    GIT_TAG v1.8.3
+    GIT_SHALLOW ON
+  )
+
+  FetchContent_MakeAvailable(benchmark_content)
+endif()
+
+# =====================
+# GoogleTest (nodewatcher_tests only)
+# =====================
+if(NODEWATCHER_BUILD_TESTS)
+  set(INSTALL_GTEST OFF CACHE BOOL "" FORCE)
+
+  FetchContent_Declare(
+    googletest_content
+    GIT_REPOSITORY https://github.com/google/googletest.git
+    GIT_TAG v1.14.0
+    GIT_SHALLOW ON
+  )
+
+  FetchContent_MakeAvailable(googletest_content)
+endif()
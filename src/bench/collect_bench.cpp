@@ -0,0 +1,174 @@
+#include <benchmark/benchmark.h>
+#include <cpu.h>
+#include <event_bus.h>
+#include <disk.h>
+#include <fixture.h>
+#include <legacy_cpu.h>
+#include <mem.h>
+#include <paths.hpp>
+#include <process.h>
+#include <proc_file.h>
+#include <proc_stat.h>
+#include <fstream>
+#include <sstream>
+
+using namespace std::chrono_literals;
+
+namespace {
+    // read()/pread() calls the calling thread has made so far. There's no such counter
+    // for open/close, the old code paired one of each with every read.
+    double readSyscalls() {
+        std::ifstream io("/proc/thread-self/io");
+        std::string key;
+        double value = 0;
+        while (io >> key >> value) {
+            if (key == "syscr:")
+                return value;
+        }
+        return 0;
+    }
+}  // namespace
+
+// One CPUInfo tick against a fixture host with range(0) CPUs: pread of /proc/stat,
+// /proc/loadavg and the cpufreq files, parsing, and the publish with nobody listening
+static void BM_CpuInfoCollect(benchmark::State& state) {
+    bench::TempDir root("host");
+    bench::writeHostTree(root.path(), static_cast<int>(state.range(0)));
+
+    // Modules resolve their paths when constructed
+    paths::setHostRoot(root.path().string());
+    EventBus eventBus;
+    CPUInfo cpu(eventBus, 1s);
+    paths::setHostRoot("");
+
+    const double reads = readSyscalls();
+    for (auto _ : state) {
+        cpu.collect();
+    }
+    state.counters["read_syscalls"] =
+        benchmark::Counter(readSyscalls() - reads, benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CpuInfoCollect)->Arg(4)->Arg(64)->Arg(256);
+
+// The same tick as the code before persistent handles did it, against the same tree.
+// Compare time and read_syscalls with BM_CpuInfoCollect at equal range(0).
+static void BM_CpuInfoCollectLegacy(benchmark::State& state) {
+    bench::TempDir root("host");
+    const int cores = static_cast<int>(state.range(0));
+    bench::writeHostTree(root.path(), cores);
+
+    legacy::CpuTick tick{};
+    tick.perCore.resize(cores);
+
+    const double reads = readSyscalls();
+    for (auto _ : state) {
+        legacy::tick(root.path(), tick);
+        benchmark::DoNotOptimize(tick);
+    }
+    state.counters["read_syscalls"] =
+        benchmark::Counter(readSyscalls() - reads, benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CpuInfoCollectLegacy)->Arg(4)->Arg(64)->Arg(256);
+
+static void BM_ProcStatParse(benchmark::State& state) {
+    bench::TempDir root("host");
+    bench::writeHostTree(root.path(), static_cast<int>(state.range(0)));
+
+    ProcFile file((root.path() / "proc/stat").string());
+    std::string data(file.read());
+
+    CpuTimes total{};
+    std::vector<CpuTimes> perCore;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(procstat::parse(data, total, perCore));
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_ProcStatParse)->Arg(4)->Arg(64)->Arg(256);
+
+// The parser BM_ProcStatParse replaced, over the same bytes: one getline scan from the
+// top for the aggregate and again for every core, O(cores^2) lines per tick
+static void BM_ProcStatParseLegacy(benchmark::State& state) {
+    bench::TempDir root("host");
+    const int cores = static_cast<int>(state.range(0));
+    bench::writeHostTree(root.path(), cores);
+
+    ProcFile file((root.path() / "proc/stat").string());
+    std::string data(file.read());
+
+    std::vector<CpuTimes> perCore(cores);
+    for (auto _ : state) {
+        std::istringstream in(data);
+        CpuTimes total = legacy::readCpuTimes(in);
+        for (int core = 0; core < cores; ++core) {
+            // The old code reopened /proc/stat here, rewinding is the in-memory analog
+            in.clear();
+            in.seekg(0);
+            perCore[core] = legacy::readCpuTimes(in, core);
+        }
+        benchmark::DoNotOptimize(total);
+        benchmark::DoNotOptimize(perCore.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_ProcStatParseLegacy)->Arg(4)->Arg(64)->Arg(256);
+
+// One MemInfo tick: pread and keyword lookup over /proc/meminfo, /proc/vmstat and
+// /proc/pressure/memory, then the publish with nobody listening
+static void BM_MemInfoCollect(benchmark::State& state) {
+    bench::TempDir root("host");
+    bench::writeHostTree(root.path(), 4);
+
+    paths::setHostRoot(root.path().string());
+    EventBus eventBus;
+    MemInfo mem(eventBus, 1s);
+    paths::setHostRoot("");
+
+    for (auto _ : state) {
+        mem.collect();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MemInfoCollect);
+
+// One DiskInfo tick over range(0) disks with partitions and loop devices next to them,
+// filtered down to the disks
+static void BM_DiskInfoCollect(benchmark::State& state) {
+    bench::TempDir root("host");
+    bench::writeDiskTree(root.path(), static_cast<int>(state.range(0)));
+
+    paths::setHostRoot(root.path().string());
+    EventBus eventBus;
+    DiskInfo disk(eventBus, 1s);
+    paths::setHostRoot("");
+
+    for (auto _ : state) {
+        disk.collect();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DiskInfoCollect)->Arg(8)->Arg(512);
+
+// One complete ProcessTable scan over range(0) fixture processes without a CPU budget:
+// getdents64, an openat/read per pid, the pid table and both partial sorts
+static void BM_ProcessTableScan(benchmark::State& state) {
+    bench::TempDir root("host");
+    bench::writeProcessTree(root.path(), static_cast<int>(state.range(0)));
+
+    paths::setHostRoot(root.path().string());
+    EventBus eventBus;
+    ProcessTable table(eventBus, 1s);
+    paths::setHostRoot("");
+
+    std::stop_source stop;
+    for (auto _ : state) {
+        HeavyContext ctx(stop.get_token(), std::chrono::hours(1));
+        table.collect(ctx);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ProcessTableScan)->Arg(1000)->Arg(50000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,176 @@
+#include <benchmark/benchmark.h>
+#include <fixture.h>
+#include <frame.h>
+#include <mpsc_ring.h>
+#include <zlib.h>
+#include <atomic>
+#include <barrier>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    constexpr int kProducers = 16;
+    constexpr int kItemsPerProducer = 4096;
+
+    // The lock-based queue MpscRing replaced, for comparison
+    class MutexQueue {
+    public:
+        explicit MutexQueue(std::size_t capacity) : capacity_(capacity) {}
+
+        bool tryPush(FramePtr value) {
+            std::lock_guard lk(mutex_);
+            if (queue_.size() >= capacity_)
+                return false;
+            queue_.push_back(std::move(value));
+            return true;
+        }
+
+        bool tryPop(FramePtr& value) {
+            std::lock_guard lk(mutex_);
+            if (queue_.empty())
+                return false;
+            value = std::move(queue_.front());
+            queue_.pop_front();
+            return true;
+        }
+
+    private:
+        std::size_t capacity_;
+        std::mutex mutex_;
+        std::deque<FramePtr> queue_;
+    };
+
+    // Each iteration 16 producer threads push 4096 frames each while this thread
+    // drains, like the collectors feeding one loop's send queue
+    template <typename Queue>
+    void runProducers(benchmark::State& state) {
+        Queue queue(1024);
+        auto frame = std::make_shared<const Frame>();
+
+        std::atomic_bool done{false};
+        std::barrier start(kProducers + 1);
+        std::vector<std::jthread> producers;
+        for (int i = 0; i < kProducers; ++i) {
+            producers.emplace_back([&] {
+                while (true) {
+                    start.arrive_and_wait();
+                    if (done.load())
+                        return;
+                    for (int n = 0; n < kItemsPerProducer; ++n) {
+                        while (!queue.tryPush(frame))
+                            std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        FramePtr out;
+        for (auto _ : state) {
+            start.arrive_and_wait();
+            for (int n = 0; n < kProducers * kItemsPerProducer;) {
+                if (queue.tryPop(out))
+                    ++n;
+            }
+        }
+
+        done = true;
+        start.arrive_and_wait();
+        state.SetItemsProcessed(state.iterations() * kProducers * kItemsPerProducer);
+    }
+}  // namespace
+
+static void BM_SendQueueMpscRing(benchmark::State& state) {
+    runProducers<MpscRing<FramePtr>>(state);
+}
+BENCHMARK(BM_SendQueueMpscRing)->UseRealTime();
+
+static void BM_SendQueueMutex(benchmark::State& state) {
+    runProducers<MutexQueue>(state);
+}
+BENCHMARK(BM_SendQueueMutex)->UseRealTime();
+
+namespace {
+    // One permessage-deflate stream, flushed at message boundaries (RFC 7692)
+    class Deflater {
+    public:
+        Deflater(int windowBits, int memLevel) {
+            deflateInit2(&stream_, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -windowBits,
+                         memLevel, Z_DEFAULT_STRATEGY);
+        }
+        ~Deflater() { deflateEnd(&stream_); }
+
+        Deflater(const Deflater&) = delete;
+        Deflater& operator=(const Deflater&) = delete;
+
+        std::size_t compress(const std::string& payload, bool reset) {
+            out_.resize(deflateBound(&stream_, payload.size()) + 16);
+            stream_.next_in =
+                reinterpret_cast<Bytef*>(const_cast<char*>(payload.data()));
+            stream_.avail_in = static_cast<uInt>(payload.size());
+            stream_.next_out = out_.data();
+            stream_.avail_out = static_cast<uInt>(out_.size());
+            deflate(&stream_, Z_SYNC_FLUSH);
+
+            // The trailing 00 00 ff ff of the sync flush is not sent
+            std::size_t size = out_.size() - stream_.avail_out - 4;
+            if (reset)
+                deflateReset(&stream_);
+            return size;
+        }
+
+    private:
+        z_stream stream_{};
+        std::vector<Bytef> out_;
+    };
+
+    std::vector<std::string> cpuInfoStream(int count) {
+        std::vector<std::string> payloads;
+        for (int i = 0; i < count; ++i) {
+            payloads.push_back(message::serializeMessage(bench::sampleCpuInfo(64, i)));
+        }
+        return payloads;
+    }
+}  // namespace
+
+// Bytes on the wire and CPU per CpuInfo tick fanned out to range(0) subscribers.
+// Shared: one context at the default window, reset and compressed once per message
+// for everybody. Dedicated: a 4 KB context (window 2^9, memLevel 2) per subscriber
+// whose window carries the repeated keys over from the previous tick.
+static void BM_CompressShared(benchmark::State& state) {
+    const auto payloads = cpuInfoStream(64);
+    Deflater deflater(15, 8);
+
+    std::size_t raw = 0, wire = 0, i = 0;
+    for (auto _ : state) {
+        const std::string& payload = payloads[i++ % payloads.size()];
+        wire += deflater.compress(payload, true) * state.range(0);
+        raw += payload.size() * state.range(0);
+    }
+    state.counters["wire_bytes_per_client"] = benchmark::Counter(
+        static_cast<double>(wire) / state.range(0), benchmark::Counter::kAvgIterations);
+    state.counters["ratio"] = static_cast<double>(wire) / raw;
+}
+BENCHMARK(BM_CompressShared)->Arg(1)->Arg(100)->Arg(1000);
+
+static void BM_CompressDedicated(benchmark::State& state) {
+    const auto payloads = cpuInfoStream(64);
+    std::vector<std::unique_ptr<Deflater>> deflaters;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        deflaters.push_back(std::make_unique<Deflater>(9, 2));
+    }
+
+    std::size_t raw = 0, wire = 0, i = 0;
+    for (auto _ : state) {
+        const std::string& payload = payloads[i++ % payloads.size()];
+        for (auto& deflater : deflaters) {
+            wire += deflater->compress(payload, false);
+        }
+        raw += payload.size() * state.range(0);
+    }
+    state.counters["wire_bytes_per_client"] = benchmark::Counter(
+        static_cast<double>(wire) / state.range(0), benchmark::Counter::kAvgIterations);
+    state.counters["ratio"] = static_cast<double>(wire) / raw;
+}
+BENCHMARK(BM_CompressDedicated)->Arg(1)->Arg(100)->Arg(1000);
@@ -0,0 +1,385 @@
+#include <fixture.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+#include <stdlib.h>
+#include <cstdio>
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+namespace bench {
+    namespace {
+        // Uniform [0, 1) from the raw engine output, std::uniform_real_distribution
+        // differs between standard libraries and would make runs incomparable
+        double uniform(std::mt19937_64& rng) {
+            return static_cast<double>(rng() >> 11) * 0x1.0p-53;
+        }
+
+        void writeFile(const std::filesystem::path& path, const std::string& data) {
+            std::filesystem::create_directories(path.parent_path());
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            file << data;
+            if (!file)
+                throw std::runtime_error("Failed to write " + path.string());
+        }
+
+        std::string cpuLine(const std::string& name, std::mt19937_64& rng, int scale) {
+            // user nice system idle iowait irq softirq steal guest guest_nice
+            std::string line = name;
+            const int weights[] = {400, 2, 120, 9000, 30, 0, 15, 0, 0, 0};
+            for (int weight : weights) {
+                line += ' ';
+                line += std::to_string(static_cast<long long>(
+                    weight * scale * (1000 + 100 * uniform(rng))));
+            }
+            return line + '\n';
+        }
+    }  // namespace
+
+    TempDir::TempDir(std::string_view prefix) {
+        std::string pattern = (std::filesystem::temp_directory_path() /
+                               ("nodewatcher-" + std::string(prefix) + "-XXXXXX"))
+                                  .string();
+        if (!mkdtemp(pattern.data()))
+            throw std::runtime_error("Failed to create temporary directory");
+        path_ = pattern;
+    }
+
+    TempDir::~TempDir() {
+        std::error_code ec;
+        std::filesystem::remove_all(path_, ec);
+    }
+
+    void writeHostTree(const std::filesystem::path& root, int cores) {
+        std::mt19937_64 rng(static_cast<uint64_t>(cores));
+
+        // /proc/stat: the aggregate and per-CPU lines, then the long counter lines the
+        // parser has to stop in front of
+        std::string stat = cpuLine("cpu ", rng, cores);
+        for (int cpu = 0; cpu < cores; ++cpu) {
+            stat += cpuLine("cpu" + std::to_string(cpu), rng, 1);
+        }
+        stat += "intr 1837263748";
+        for (int i = 0; i < 256 + cores; ++i) {
+            stat += ' ' + std::to_string(static_cast<int>(1000 * uniform(rng)));
+        }
+        stat += "\nctxt 3859238412\nbtime 1718000000\nprocesses 4829301\n"
+                "procs_running 3\nprocs_blocked 0\n"
+                "softirq 918273645 12 283746 19 837465 9182 0 7364 283746 0 918273\n";
+        writeFile(root / "proc/stat", stat);
+
+        writeFile(root / "proc/loadavg", "1.52 1.38 1.21 3/1234 567890\n");
+
+        // Real files list ~55 and ~170 keys, MemInfo only looks for a handful of them
+        writeFile(root / "proc/meminfo",
+                  "MemTotal:           263847360 kB\n"
+                  "MemFree:             18273640 kB\n"
+                  "MemAvailable:       201837264 kB\n"
+                  "Buffers:              1827364 kB\n"
+                  "Cached:             172635488 kB\n"
+                  "SwapCached:              1024 kB\n"
+                  "Active:              98273645 kB\n"
+                  "Inactive:           120938475 kB\n"
+                  "SwapTotal:            8388604 kB\n"
+                  "SwapFree:             8120340 kB\n"
+                  "Dirty:                  18236 kB\n"
+                  "Writeback:                128 kB\n"
+                  "AnonPages:           45362718 kB\n"
+                  "Mapped:               2837465 kB\n"
+                  "Shmem:                 182736 kB\n"
+                  "Slab:                12837465 kB\n"
+                  "SReclaimable:         9283746 kB\n"
+                  "SUnreclaim:           3553719 kB\n"
+                  "KernelStack:            48320 kB\n"
+                  "PageTables:            283746 kB\n"
+                  "CommitLimit:        140312284 kB\n"
+                  "Committed_AS:        83746251 kB\n"
+                  "VmallocTotal:     34359738367 kB\n"
+                  "Hugepagesize:            2048 kB\n");
+
+        std::string vmstat;
+        for (int i = 0; i < 100; ++i) {
+            vmstat += "nr_counter_" + std::to_string(i) + ' ' +
+                      std::to_string(static_cast<long long>(1e9 * uniform(rng))) + '\n';
+        }
+        vmstat += "pgmajfault 182736\n";
+        for (int i = 0; i < 70; ++i) {
+            vmstat += "event_counter_" + std::to_string(i) + ' ' +
+                      std::to_string(static_cast<long long>(1e9 * uniform(rng))) + '\n';
+        }
+        writeFile(root / "proc/vmstat", vmstat);
+
+        writeFile(root / "proc/pressure/memory",
+                  "some avg10=0.31 avg60=0.12 avg300=0.04 total=182736451\n"
+                  "full avg10=0.10 avg60=0.03 avg300=0.01 total=82736451\n");
+
+        // One block per logical CPU, two threads per core
+        std::string cpuinfo;
+        for (int cpu = 0; cpu < cores; ++cpu) {
+            cpuinfo += "processor\t: " + std::to_string(cpu) +
+                       "\nvendor_id\t: GenuineIntel\ncpu family\t: 6\nmodel\t\t: 106\n"
+                       "model name\t: Intel(R) Xeon(R) Platinum 8380 CPU @ 2.30GHz\n"
+                       "stepping\t: 6\ncpu MHz\t\t: 2300.000\ncache size\t: 61440 KB\n"
+                       "physical id\t: " +
+                       std::to_string(cpu / 64) +
+                       "\nsiblings\t: 128\n"
+                       "core id\t\t: " +
+                       std::to_string((cpu % 64) / 2) +
+                       "\ncpu cores\t: 32\n"
+                       "flags\t\t: fpu vme de pse tsc msr pae mce cx8 apic sep mtrr pge "
+                       "mca cmov pat pse36 clflush dts acpi mmx fxsr sse sse2 ss ht tm "
+                       "pbe syscall nx pdpe1gb rdtscp lm constant_tsc avx avx2 avx512f"
+                       "\nbogomips\t: 4600.00\n\n";
+        }
+        writeFile(root / "proc/cpuinfo", cpuinfo);
+
+        writeFile(root / "sys/devices/system/cpu/online",
+                  "0-" + std::to_string(cores - 1) + "\n");
+
+        for (int cpu = 0; cpu < cores; ++cpu) {
+            auto dir = root / ("sys/devices/system/cpu/cpu" + std::to_string(cpu)) /
+                       "cpufreq";
+            writeFile(dir / "scaling_cur_freq",
+                      std::to_string(800000 + static_cast<int>(2600000 * uniform(rng))) +
+                          "\n");
+            writeFile(dir / "cpuinfo_max_freq", "3400000\n");
+        }
+    }
+
+    void writeDiskTree(const std::filesystem::path& root, int disks) {
+        std::mt19937_64 rng(static_cast<uint64_t>(disks));
+        auto counter = [&] {
+            return std::to_string(static_cast<long long>(1e9 * uniform(rng)));
+        };
+
+        // major minor name, then the 17 counter fields of a 5.5+ kernel
+        std::string diskstats;
+        auto line = [&](int major, int minor, const std::string& name) {
+            diskstats += "   " + std::to_string(major) + "   " + std::to_string(minor) +
+                         ' ' + name;
+            for (int field = 0; field < 17; ++field) {
+                diskstats += ' ' + (field == 8 ? std::string("2") : counter());
+            }
+            diskstats += '\n';
+        };
+
+        for (int i = 0; i < disks; ++i) {
+            line(7, i, "loop" + std::to_string(i));
+            writeFile(root / "sys/block" / ("loop" + std::to_string(i)) / "size", "0\n");
+        }
+
+        for (int i = 0; i < disks; ++i) {
+            std::string name = "nvme" + std::to_string(i) + "n1";
+            line(259, 3 * i, name);
+            line(259, 3 * i + 1, name + "p1");
+            line(259, 3 * i + 2, name + "p2");
+
+            auto dir = root / "sys/block" / name;
+            writeFile(dir / "size", "3907029168\n");
+            writeFile(dir / "queue/rotational", "0\n");
+            writeFile(dir / "queue/scheduler", "[none] mq-deadline\n");
+        }
+        writeFile(root / "proc/diskstats", diskstats);
+    }
+
+    void writeProcessTree(const std::filesystem::path& root, int processes) {
+        std::mt19937_64 rng(static_cast<uint64_t>(processes));
+        writeFile(root / "proc/uptime", "864000.00 6912000.00\n");
+
+        for (int pid = 1; pid <= processes; ++pid) {
+            auto ticks = [&](double scale) {
+                return std::to_string(static_cast<long long>(scale * uniform(rng)));
+            };
+
+            // 52 fields; utime, stime, num_threads, starttime and rss are what counts
+            const std::string id = std::to_string(pid);
+            std::string stat = id + " (worker-" + std::to_string(pid % 97) + ") S 1 " +
+                               id + ' ' + id + " 0 -1 4194560 " + ticks(1e5) + " 0 " +
+                               ticks(100) + " 0 " + ticks(1e6) + ' ' + ticks(1e5) +
+                               " 0 0 20 0 4 0 " + ticks(8.64e7) + " 1073741824 " +
+                               ticks(1e5) + " 18446744073709551615";
+            for (int field = 26; field <= 52; ++field) {
+                stat += " 0";
+            }
+            writeFile(root / "proc" / std::to_string(pid) / "stat", stat + '\n');
+        }
+    }
+
+    Certificate writeCertificate(const std::filesystem::path& dir) {
+        EVP_PKEY* key = EVP_EC_gen("P-256");
+        X509* cert = X509_new();
+        if (!key || !cert)
+            throw std::runtime_error("Failed to generate certificate");
+
+        X509_set_version(cert, 2);
+        ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+        X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+        X509_gmtime_adj(X509_getm_notAfter(cert), 7 * 24 * 3600);
+        X509_set_pubkey(cert, key);
+
+        X509_NAME* name = X509_get_subject_name(cert);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                                   reinterpret_cast<const unsigned char*>("localhost"),
+                                   -1, -1, 0);
+        X509_set_issuer_name(cert, name);
+        X509_sign(cert, key, EVP_sha256());
+
+        Certificate files{(dir / "key.pem").string(), (dir / "cert.pem").string()};
+
+        FILE* keyOut = std::fopen(files.keyFile.c_str(), "w");
+        FILE* certOut = std::fopen(files.certFile.c_str(), "w");
+        bool ok = keyOut && certOut &&
+                  PEM_write_PrivateKey(keyOut, key, nullptr, nullptr, 0, nullptr,
+                                       nullptr) == 1 &&
+                  PEM_write_X509(certOut, cert) == 1;
+
+        if (keyOut)
+            std::fclose(keyOut);
+        if (certOut)
+            std::fclose(certOut);
+        X509_free(cert);
+        EVP_PKEY_free(key);
+
+        if (!ok)
+            throw std::runtime_error("Failed to write certificate");
+        return files;
+    }
+
+    message::CpuInfo sampleCpuInfo(int cores, uint64_t seed) {
+        std::mt19937_64 rng(seed);
+
+        std::vector<double> perCore(cores);
+        for (double& usage : perCore) {
+            usage = 100.0 * uniform(rng);
+        }
+
+        return message::CpuInfo(1.52, 1.38, 1.21, 100.0 * uniform(rng), perCore,
+                                800000 + static_cast<int>(2600000 * uniform(rng)));
+    }
+
+    message::CpuHistory sampleCpuHistory(int cores, int samples) {
+        message::CpuHistory history;
+        history.per_core_usage.resize(cores);
+
+        for (int i = 0; i < samples; ++i) {
+            message::CpuInfo sample = sampleCpuInfo(cores, i);
+            history.timestamps.push_back(1718000000000 + 1000 * int64_t{i});
+            history.cpu_load_avg_1min.push_back(sample.cpu_load_avg_1min);
+            history.cpu_load_avg_5min.push_back(sample.cpu_load_avg_5min);
+            history.cpu_load_avg_15min.push_back(sample.cpu_load_avg_15min);
+            history.cpu_usage.push_back(sample.cpu_usage);
+            history.cpu_frequency.push_back(sample.cpu_frequency);
+            for (int core = 0; core < cores; ++core) {
+                history.per_core_usage[core].push_back(sample.per_core_usage[core]);
+            }
+        }
+        return history;
+    }
+
+    message::CpuRollup sampleCpuRollup(int cores) {
+        std::mt19937_64 rng(cores);
+        auto stats = [&] {
+            double a = 100.0 * uniform(rng);
+            double b = 100.0 * uniform(rng);
+            return message::RollupStats{std::min(a, b), std::max(a, b), (a + b) / 2,
+                                        std::max(a, b) * 0.97};
+        };
+
+        message::CpuRollup rollup;
+        rollup.window_s = 60;
+        rollup.start = 1718000040000;
+        rollup.samples = 60;
+        rollup.cpu_load_avg_1min = stats();
+        rollup.cpu_load_avg_5min = stats();
+        rollup.cpu_load_avg_15min = stats();
+        rollup.cpu_usage = stats();
+        rollup.cpu_frequency = stats();
+        for (int core = 0; core < cores; ++core) {
+            rollup.per_core_usage.push_back(stats());
+        }
+        return rollup;
+    }
+
+    message::SelfStats sampleSelfStats() {
+        message::SelfStats stats;
+        stats.counters = {{"server.dropped_frames", 12},
+                          {"process.cpu_user_us", 8273645},
+                          {"process.cpu_system_us", 1827364},
+                          {"process.max_rss_kb", 18432}};
+
+        for (const char* name :
+             {"collect.cpu_ns", "collect.system_ns", "server.encode_ns",
+              "server.serialize_ns", "server.flush_ns", "server.flush_batch",
+              "server.queue_depth", "server.auth_ns"}) {
+            stats.histograms.push_back({name, 86400, 1200, 18000, 15000, 31000, 88000,
+                                        410000});
+        }
+        return stats;
+    }
+
+    message::MemInfo sampleMemInfo() {
+        message::MemInfo mem;
+        mem.mem_available = 201837264;
+        mem.mem_used = 62010096;
+        mem.mem_usage = 23.502381;
+        mem.swap_used = 268264;
+        mem.swap_usage = 3.197960;
+        mem.cached = 172635488;
+        mem.dirty = 18236;
+        mem.writeback = 128;
+        mem.major_faults = 12.4;
+        mem.pressure_some_avg10 = 0.31;
+        mem.pressure_some_avg60 = 0.12;
+        mem.pressure_full_avg10 = 0.10;
+        mem.pressure_full_avg60 = 0.03;
+        return mem;
+    }
+
+    message::DiskInfoStatic sampleDiskInfoStatic(int disks) {
+        message::DiskInfoStatic info;
+        for (int i = 0; i < disks; ++i) {
+            info.devices.push_back({"nvme" + std::to_string(i) + "n1", i % 4 == 3,
+                                    3840755982336LL, "none"});
+        }
+        return info;
+    }
+
+    message::DiskInfo sampleDiskInfo(int disks) {
+        message::DiskInfo info;
+        for (int i = 0; i < disks; ++i) {
+            info.devices.push_back({"nvme" + std::to_string(i) + "n1", 1204.5 + i,
+                                    388.25, 98304000.0 + i * 4096, 27721728.0, 1.84,
+                                    0.412, 37.5});
+        }
+        return info;
+    }
+
+    message::NetInfo sampleNetInfo(int interfaces) {
+        message::NetInfo info;
+        for (int i = 0; i < interfaces; ++i) {
+            message::NetStat stat{"eth" + std::to_string(i), 118734592.5 + i, 9342976.0,
+                                  81234.0, 40117.5, 0.0, 0.0, 1.5, 0.0};
+            info.total.rx_bytes += stat.rx_bytes;
+            info.total.tx_bytes += stat.tx_bytes;
+            info.total.rx_packets += stat.rx_packets;
+            info.total.tx_packets += stat.tx_packets;
+            info.total.rx_dropped += stat.rx_dropped;
+            info.interfaces.push_back(std::move(stat));
+        }
+        return info;
+    }
+
+    message::ProcessInfo sampleProcessInfo(int topN) {
+        message::ProcessInfo info;
+        info.processes = 1873;
+        for (int i = 0; i < topN; ++i) {
+            info.top_cpu.push_back(
+                {4211 + i, "postgres: worker", 98.5 - i * 7.25, 1048576 + i * 512, 12});
+            info.top_memory.push_back(
+                {1024 + i, "java", 12.0 + i, 16777216 - i * 65536, 184});
+        }
+        return info;
+    }
+}  // namespace bench
@@ -0,0 +1,57 @@
+#ifndef BENCH_FIXTURE_H
+#define BENCH_FIXTURE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <json.hpp>
+#include <string>
+#include <string_view>
+
+namespace bench {
+    // Scratch directory under the system temp dir, removed with everything in it
+    class TempDir {
+    public:
+        explicit TempDir(std::string_view prefix);
+        ~TempDir();
+
+        TempDir(const TempDir&) = delete;
+        TempDir& operator=(const TempDir&) = delete;
+
+        const std::filesystem::path& path() const { return path_; }
+
+    private:
+        std::filesystem::path path_;
+    };
+
+    // Writes the /proc and /sys files CPUInfo and MemInfo read for a machine with
+    // `cores` CPUs under root, for use with paths::setHostRoot()
+    void writeHostTree(const std::filesystem::path& root, int cores);
+
+    // Writes /proc/diskstats and /sys/block for `disks` disks with two partitions each,
+    // plus as many loop devices
+    void writeDiskTree(const std::filesystem::path& root, int disks);
+
+    // Writes /proc/uptime and a /proc/[pid]/stat for each of `processes` processes
+    void writeProcessTree(const std::filesystem::path& root, int processes);
+
+    struct Certificate {
+        std::string keyFile;
+        std::string certFile;
+    };
+
+    // Self-signed P-256 certificate for localhost, written as PEM into dir
+    Certificate writeCertificate(const std::filesystem::path& dir);
+
+    // Deterministic samples, the same seed gives the same bytes on every run
+    message::CpuInfo sampleCpuInfo(int cores, uint64_t seed);
+    message::CpuHistory sampleCpuHistory(int cores, int samples);
+    message::CpuRollup sampleCpuRollup(int cores);
+    message::SelfStats sampleSelfStats();
+    message::MemInfo sampleMemInfo();
+    message::DiskInfoStatic sampleDiskInfoStatic(int disks);
+    message::DiskInfo sampleDiskInfo(int disks);
+    message::NetInfo sampleNetInfo(int interfaces);
+    message::ProcessInfo sampleProcessInfo(int topN);
+}  // namespace bench
+
+#endif  // BENCH_FIXTURE_H
@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+#include <event_bus.h>
+#include <fixture.h>
+#include <journal.h>
+#include <chrono>
+
+namespace {
+    constexpr int kCores = 256;
+    constexpr int64_t kDayMs = 24 * 3600 * 1000;
+
+    int64_t nowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+
+    // A few distinct samples reused round-robin, generating one per append would
+    // dominate the measurement
+    std::vector<message::CpuInfo> samples() {
+        std::vector<message::CpuInfo> result;
+        for (int i = 0; i < 64; ++i) {
+            result.push_back(bench::sampleCpuInfo(kCores, i));
+        }
+        return result;
+    }
+
+    // 24 hours of 1 Hz samples of a 256-CPU host, written once and shared by the
+    // scan benchmarks
+    struct DayJournal {
+        bench::TempDir dir{"journal"};
+        EventBus eventBus;
+        Journal journal{eventBus, dir.path()};
+        int64_t endMs = nowMs();
+
+        DayJournal() {
+            const auto cpu = samples();
+            for (int64_t i = 0; i < kDayMs / 1000; ++i) {
+                journal.append(endMs - kDayMs + 1000 * i, cpu[i % cpu.size()]);
+            }
+        }
+    };
+
+    DayJournal& dayJournal() {
+        static DayJournal journal;
+        return journal;
+    }
+}  // namespace
+
+static void BM_JournalAppend(benchmark::State& state) {
+    bench::TempDir dir("journal");
+    EventBus eventBus;
+    Journal journal(eventBus, dir.path());
+    const auto cpu = samples();
+
+    int64_t timestamp = nowMs() - kDayMs;
+    std::size_t i = 0;
+    for (auto _ : state) {
+        journal.append(timestamp, cpu[i++ % cpu.size()]);
+        timestamp += 1000;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_JournalAppend);
+
+// Decodes the last range(0) hours of the day journal
+static void BM_JournalScan(benchmark::State& state) {
+    DayJournal& day = dayJournal();
+    const int64_t fromMs = day.endMs - state.range(0) * 3600 * 1000;
+
+    int64_t count = 0;
+    for (auto _ : state) {
+        day.journal.scan(fromMs, day.endMs, [&](const JournalSample& sample) {
+            benchmark::DoNotOptimize(sample.perCore.data());
+            ++count;
+        });
+    }
+    state.SetItemsProcessed(count);
+    state.counters["values"] = benchmark::Counter(
+        static_cast<double>(count) * (5 + kCores), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_JournalScan)->Arg(1)->Arg(24)->Unit(benchmark::kMillisecond);
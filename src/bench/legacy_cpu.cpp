@@ -0,0 +1,55 @@
+#include <legacy_cpu.h>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace legacy {
+    CpuTimes readCpuTimes(std::istream& in, int core) {
+        std::string line;
+
+        while (std::getline(in, line)) {
+            if ((core == -1 && line.starts_with("cpu ")) ||
+                (core >= 0 && line.starts_with("cpu" + std::to_string(core)))) {
+                CpuTimes t{};
+                std::stringstream ss(line);
+                std::string cpu;
+                ss >> cpu >> t.user >> t.nice >> t.system >> t.idle >> t.iowait >>
+                    t.irq >> t.softirq >> t.steal;
+                return t;
+            }
+        }
+        return {};
+    }
+
+    void tick(const std::filesystem::path& root, CpuTick& out) {
+        if (getloadavg(out.load, 3) != 3)
+            out.load[0] = out.load[1] = out.load[2] = 0.0;
+
+        {
+            std::ifstream f(root / "proc/stat");
+            out.total = readCpuTimes(f);
+        }
+        for (std::size_t core = 0; core < out.perCore.size(); ++core) {
+            std::ifstream f(root / "proc/stat");
+            out.perCore[core] = readCpuTimes(f, static_cast<int>(core));
+        }
+
+        long long sum = 0;
+        int count = 0;
+        for (int cpu = 0;; ++cpu) {
+            std::ifstream f(root / ("sys/devices/system/cpu/cpu" + std::to_string(cpu) +
+                                    "/cpufreq/scaling_cur_freq"));
+            if (!f.is_open())
+                break;
+
+            long khz = 0;
+            f >> khz;
+            if (khz > 0) {
+                sum += khz;
+                ++count;
+            }
+        }
+        out.frequency = count == 0 ? 0 : static_cast<int>(sum / count);
+    }
+}  // namespace legacy
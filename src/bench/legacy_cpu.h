@@ -0,0 +1,29 @@
+#ifndef BENCH_LEGACY_CPU_H
+#define BENCH_LEGACY_CPU_H
+
+#include <proc_stat.h>
+#include <filesystem>
+#include <istream>
+#include <vector>
+
+// The CPUInfo sampling code as it was before ProcFile and procstat::parse, kept only so
+// the benchmarks can compare against it. Do not use it anywhere else.
+namespace legacy {
+    // Scans from the top with std::getline until the "cpu " line (core -1) or the first
+    // line starting with "cpuN", then parses it through a std::stringstream
+    CpuTimes readCpuTimes(std::istream& in, int core = -1);
+
+    struct CpuTick {
+        double load[3];
+        CpuTimes total;
+        std::vector<CpuTimes> perCore;  // Sized by the caller
+        int frequency;
+    };
+
+    // One CPUInfo::collect() of the old code against a host tree at root, without the
+    // publish: getloadavg(), /proc/stat opened once for the aggregate and once per
+    // core, then every cpuN/cpufreq/scaling_cur_freq until one fails to open
+    void tick(const std::filesystem::path& root, CpuTick& out);
+}  // namespace legacy
+
+#endif  // BENCH_LEGACY_CPU_H
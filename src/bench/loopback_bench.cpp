@@ -0,0 +1,180 @@
+#include <api_keys.h>
+#include <benchmark/benchmark.h>
+#include <event_bus.h>
+#include <fixture.h>
+#include <metrics.h>
+#include <server.h>
+#include <ws_client.h>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    int benchPort() {
+        const char* env = std::getenv("NODEWATCHER_BENCH_PORT");
+        return env ? std::atoi(env) : 15055;
+    }
+
+    int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   Clock::now().time_since_epoch())
+            .count();
+    }
+
+    // The benchmark sends its sequence number in cpu_frequency, negative while warming
+    // up. Found with a substring search so clients stay cheap next to the server.
+    std::optional<int> sequenceOf(std::string_view payload) {
+        constexpr std::string_view field = "\"cpu_frequency\":";
+        std::size_t pos = payload.find(field);
+        if (pos == std::string_view::npos)
+            return std::nullopt;
+
+        int seq = 0;
+        const char* begin = payload.data() + pos + field.size();
+        auto [next, ec] = std::from_chars(begin, payload.data() + payload.size(), seq);
+        if (ec != std::errc())
+            return std::nullopt;
+        return seq;
+    }
+
+    double percentile(const std::vector<int64_t>& sorted, double p) {
+        if (sorted.empty())
+            return 0;
+        std::size_t rank = static_cast<std::size_t>(p * (sorted.size() - 1) + 0.5);
+        return static_cast<double>(sorted[rank]) / 1000.0;
+    }
+}  // namespace
+
+// Publish-to-receive latency of one CpuInfo through the full server path (EventBus,
+// encode, send queue, loop flush, TLS) to range(0) authenticated websocket clients on
+// range(1) event loops. Every iteration waits until each client has the message.
+// Percentiles are per delivered message, in microseconds.
+static void BM_BroadcastLatency(benchmark::State& state) {
+    const int clients = static_cast<int>(state.range(0));
+    const unsigned loops = static_cast<unsigned>(state.range(1));
+
+    bench::TempDir dir("loopback");
+    bench::Certificate cert = bench::writeCertificate(dir.path());
+
+    KeyStore keystore;
+    const std::string key = keystore.generateNewKey();
+    keystore.addKey({key, "bench"});
+
+    // The dropped-frames counter is process wide
+    const uint64_t droppedBefore = metrics::counter("server.dropped_frames").value();
+
+    EventBus eventBus;
+    Server server({.key_file_name = cert.keyFile.c_str(),
+                   .cert_file_name = cert.certFile.c_str()},
+                  keystore, eventBus, {.threads = loops});
+    server.run(benchPort());
+
+    // Sent timestamps by sequence number, written before the publish
+    std::vector<std::atomic<int64_t>> sent(state.max_iterations);
+    std::atomic<int64_t> received{0};
+    std::atomic<int> warm{0};
+    std::vector<std::vector<int64_t>> latencies(clients);
+
+    std::vector<std::unique_ptr<bench::WsClient>> sockets;
+    std::vector<std::jthread> readers;
+    for (int i = 0; i < clients; ++i) {
+        auto client = std::make_unique<bench::WsClient>();
+        if (!client->connect("127.0.0.1", benchPort()) ||
+            !client->authenticate("bench", key)) {
+            state.SkipWithError("Client failed to connect or authenticate");
+            break;
+        }
+
+        readers.emplace_back([&, client = client.get(), &out = latencies[i]] {
+            bool warmedUp = false;
+            out.reserve(state.max_iterations);
+            while (auto payload = client->read()) {
+                const int64_t now = nowNs();
+                std::optional<int> seq = sequenceOf(*payload);
+                if (!seq)
+                    continue;
+
+                if (*seq < 0) {
+                    if (!std::exchange(warmedUp, true))
+                        warm.fetch_add(1);
+                    continue;
+                }
+
+                out.push_back(now - sent[*seq].load(std::memory_order_acquire));
+                received.fetch_add(1, std::memory_order_release);
+            }
+        });
+        sockets.push_back(std::move(client));
+    }
+
+    message::CpuInfo sample = bench::sampleCpuInfo(64, 1);
+
+    // Subscriptions are set up right after AUTH_RESULT goes out, keep publishing until
+    // every client is actually receiving
+    const auto deadline = Clock::now() + std::chrono::seconds(10);
+    while (!state.error_occurred() && warm.load() < clients) {
+        if (Clock::now() > deadline) {
+            state.SkipWithError("Clients never received a broadcast");
+            break;
+        }
+        sample.cpu_frequency = -1;
+        eventBus.publish(sample);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    int64_t seq = 0;
+    for (auto _ : state) {
+        if (state.error_occurred())
+            break;
+
+        sent[seq].store(nowNs(), std::memory_order_release);
+        sample.cpu_frequency = static_cast<int>(seq);
+        eventBus.publish(sample);
+        ++seq;
+
+        const auto timeout = Clock::now() + std::chrono::seconds(5);
+        while (received.load(std::memory_order_acquire) < seq * clients) {
+            if (Clock::now() > timeout) {
+                state.SkipWithError("Timed out waiting for clients");
+                break;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    for (auto& client : sockets) {
+        client->shutdown();
+    }
+    readers.clear();
+    sockets.clear();
+    server.stop();
+
+    std::vector<int64_t> all;
+    for (const auto& client : latencies) {
+        all.insert(all.end(), client.begin(), client.end());
+    }
+    std::sort(all.begin(), all.end());
+
+    state.SetItemsProcessed(static_cast<int64_t>(all.size()));
+    state.counters["p50_us"] = percentile(all, 0.50);
+    state.counters["p90_us"] = percentile(all, 0.90);
+    state.counters["p99_us"] = percentile(all, 0.99);
+    state.counters["max_us"] = percentile(all, 1.0);
+    state.counters["dropped"] =
+        static_cast<double>(server.droppedFrames() - droppedBefore);
+}
+BENCHMARK(BM_BroadcastLatency)
+    ->Args({1, 1})
+    ->Args({10, 1})
+    ->Args({100, 1})
+    ->Args({100, 4})
+    ->ArgNames({"clients", "loops"})
+    ->Iterations(2000)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
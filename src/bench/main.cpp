@@ -0,0 +1,18 @@
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+
+int main(int argc, char** argv) {
+    // API keys and other state land next to the binary, never in /var/lib/nodewatcher
+    setenv("NODEWATCHER_ENV", "development", 1);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    // Recorded in the JSON context so result files say which commit they measured
+    benchmark::AddCustomContext("git_revision", NODEWATCHER_GIT_REVISION);
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,176 @@
+#include <auth.h>
+#include <benchmark/benchmark.h>
+#include <fixture.h>
+#include <json.hpp>
+
+// message::serializeMessage for every outbound type, into a reused buffer the way the
+// server's encode path calls it
+static void BM_Serialize(benchmark::State& state, message::MessageVariantOUT msg) {
+    std::string out;
+    for (auto _ : state) {
+        out.clear();
+        message::serializeMessage(msg, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(state.iterations() * out.size());
+    state.counters["bytes"] = static_cast<double>(out.size());
+}
+BENCHMARK_CAPTURE(BM_Serialize, error, message::Error{400, "Unknown message type"});
+BENCHMARK_CAPTURE(BM_Serialize,
+                  auth_challenge,
+                  message::AuthChallenge("6f1c2a9e0b7d4e3f8a5c1b2d3e4f5a6b"));
+BENCHMARK_CAPTURE(BM_Serialize,
+                  auth_result,
+                  message::AuthResult(true, "Authentication successful"));
+BENCHMARK_CAPTURE(BM_Serialize,
+                  system_info_static,
+                  message::SystemInfoStatic("node-01.example.internal",
+                                            "Debian GNU/Linux", "12", "6.1.0-21-amd64",
+                                            "Europe/Warsaw"));
+BENCHMARK_CAPTURE(BM_Serialize,
+                  system_info,
+                  message::SystemInfo("12 days, 4:31:07", "2024-06-10 14:21:33"));
+BENCHMARK_CAPTURE(BM_Serialize,
+                  cpu_info_static,
+                  message::CpuInfoStatic("Intel(R) Xeon(R) Platinum 8380 CPU @ 2.30GHz",
+                                         "x86_64", 3400000, 64, 128));
+BENCHMARK_CAPTURE(BM_Serialize, cpu_info_8, bench::sampleCpuInfo(8, 1));
+BENCHMARK_CAPTURE(BM_Serialize, cpu_info_64, bench::sampleCpuInfo(64, 1));
+BENCHMARK_CAPTURE(BM_Serialize, cpu_info_256, bench::sampleCpuInfo(256, 1));
+BENCHMARK_CAPTURE(BM_Serialize, cpu_history_300x8, bench::sampleCpuHistory(8, 300));
+BENCHMARK_CAPTURE(BM_Serialize, cpu_rollup_64, bench::sampleCpuRollup(64));
+BENCHMARK_CAPTURE(BM_Serialize, self_stats, bench::sampleSelfStats());
+BENCHMARK_CAPTURE(BM_Serialize,
+                  mem_info_static,
+                  message::MemInfoStatic(263847360, 8388604));
+BENCHMARK_CAPTURE(BM_Serialize, mem_info, bench::sampleMemInfo());
+BENCHMARK_CAPTURE(BM_Serialize, disk_info_static_8, bench::sampleDiskInfoStatic(8));
+BENCHMARK_CAPTURE(BM_Serialize, disk_info_8, bench::sampleDiskInfo(8));
+BENCHMARK_CAPTURE(BM_Serialize, disk_info_64, bench::sampleDiskInfo(64));
+BENCHMARK_CAPTURE(BM_Serialize, net_info_4, bench::sampleNetInfo(4));
+BENCHMARK_CAPTURE(BM_Serialize, net_info_64, bench::sampleNetInfo(64));
+BENCHMARK_CAPTURE(BM_Serialize, process_info_10, bench::sampleProcessInfo(10));
+
+// The same CpuInfo through the nlohmann DOM path and the binary encodings
+static void BM_SerializeEncoding(benchmark::State& state) {
+    const message::MessageVariantOUT msg = bench::sampleCpuInfo(64, 1);
+    const auto encoding = static_cast<message::Encoding>(state.range(0));
+    state.SetLabel(std::string(message::encodingName(encoding)));
+
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        std::string out = message::serializeMessage(msg, encoding);
+        bytes = out.size();
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+    state.counters["bytes"] = static_cast<double>(bytes);
+}
+BENCHMARK(BM_SerializeEncoding)
+    ->Arg(static_cast<int>(message::Encoding::JSON))
+    ->Arg(static_cast<int>(message::Encoding::MSGPACK))
+    ->Arg(static_cast<int>(message::Encoding::CBOR));
+
+static void BM_SerializeReference(benchmark::State& state) {
+    const message::MessageVariantOUT msg = bench::sampleCpuInfo(64, 1);
+    for (auto _ : state) {
+        std::string out = message::serializeMessageReference(msg);
+        benchmark::DoNotOptimize(out.data());
+    }
+}
+BENCHMARK(BM_SerializeReference);
+
+// One second of 500 nodes reporting at 1 Hz into one server: every node's CPU, memory,
+// disk and network sample. range(0) 1 takes the nlohmann DOM path serialization used
+// before it moved to the producer. Time per iteration is the CPU that second costs.
+static void BM_SerializeFleetSecond(benchmark::State& state) {
+    constexpr int kNodes = 500;
+    std::vector<message::MessageVariantOUT> second;
+    second.reserve(4 * kNodes);
+    for (int node = 0; node < kNodes; ++node) {
+        second.push_back(bench::sampleCpuInfo(16, static_cast<uint64_t>(node)));
+        second.push_back(bench::sampleMemInfo());
+        second.push_back(bench::sampleDiskInfo(4));
+        second.push_back(bench::sampleNetInfo(2));
+    }
+
+    const bool reference = state.range(0) == 1;
+    std::string out;
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        bytes = 0;
+        for (const auto& msg : second) {
+            if (reference) {
+                out = message::serializeMessageReference(msg);
+            } else {
+                out.clear();
+                message::serializeMessage(msg, out);
+            }
+            bytes += out.size();
+            benchmark::DoNotOptimize(out.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * second.size());
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_SerializeFleetSecond)
+    ->ArgName("reference")
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_ParseMessage(benchmark::State& state, std::string payload) {
+    for (auto _ : state) {
+        auto msg = message::parseMessage(payload);
+        benchmark::DoNotOptimize(msg);
+    }
+    state.SetBytesProcessed(state.iterations() * payload.size());
+}
+BENCHMARK_CAPTURE(BM_ParseMessage,
+                  auth_response,
+                  nlohmann::json(message::AuthResponse(
+                                     "admin_3b5d5c3712955042212316173ccf37be800"
+                                     "9d5fd2d8c0e1a1f3a0d8c4b2e7f9a1",
+                                     message::Encoding::MSGPACK, true))
+                      .dump());
+BENCHMARK_CAPTURE(BM_ParseMessage,
+                  subscribe,
+                  nlohmann::json(message::Subscribe({message::Type::CPU_INFO,
+                                                     message::Type::SYSTEM_INFO},
+                                                    1000))
+                      .dump());
+BENCHMARK_CAPTURE(BM_ParseMessage,
+                  history_request,
+                  nlohmann::json(message::HistoryRequest({message::Type::CPU_INFO}, 3600))
+                      .dump());
+BENCHMARK_CAPTURE(BM_ParseMessage, malformed, std::string(R"({"type":"AUTH_RESP)"));
+
+static void BM_GetMessageType(benchmark::State& state, std::string payload) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(message::getMessageType(std::string_view(payload)));
+    }
+    state.SetBytesProcessed(state.iterations() * payload.size());
+}
+BENCHMARK_CAPTURE(BM_GetMessageType,
+                  auth_response,
+                  nlohmann::json(message::AuthResponse("admin_0123456789abcdef")).dump());
+BENCHMARK_CAPTURE(BM_GetMessageType,
+                  cpu_info_64,
+                  message::serializeMessage(bench::sampleCpuInfo(64, 1)));
+
+static void BM_HmacSha256(benchmark::State& state) {
+    const std::string key(64, 'k');
+    const std::string nonce = auth::generateNonce();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(auth::hmacSha256(key, nonce));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HmacSha256);
+
+static void BM_GenerateNonce(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(auth::generateNonce());
+    }
+}
+BENCHMARK(BM_GenerateNonce);
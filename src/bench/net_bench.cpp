@@ -0,0 +1,176 @@
+#include <benchmark/benchmark.h>
+#include <fixture.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <proc_file.h>
+#include <rtnl_link.h>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+    struct NetDevCounters {
+        std::string name;
+        unsigned long long values[16];
+    };
+
+    // What NetInfo would do without netlink: split /proc/net/dev into lines and parse
+    // the 16 counters after each "name:"
+    void parseNetDev(std::string_view data, std::vector<NetDevCounters>& out) {
+        out.clear();
+        const char* p = data.data();
+        const char* end = p + data.size();
+
+        for (int header = 0; header < 2 && p < end; ++header) {
+            const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            p = eol ? eol + 1 : end;
+        }
+
+        while (p < end) {
+            const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (eol == nullptr)
+                eol = end;
+
+            while (p < eol && *p == ' ')
+                ++p;
+            const char* colon = static_cast<const char*>(std::memchr(p, ':', eol - p));
+            if (colon != nullptr) {
+                NetDevCounters& counters = out.emplace_back();
+                counters.name.assign(p, colon);
+
+                const char* q = colon + 1;
+                for (unsigned long long& value : counters.values) {
+                    while (q < eol && *q == ' ')
+                        ++q;
+                    q = std::from_chars(q, eol, value).ptr;
+                }
+            }
+
+            p = eol + 1;
+        }
+    }
+
+    std::string interfaceName(int i) {
+        return i == 0 ? "lo" : i == 1 ? "eth0" : "veth" + std::to_string(100000 + i);
+    }
+
+    void writeNetDev(const std::filesystem::path& file, int interfaces) {
+        std::string text =
+            "Inter-|   Receive                            "
+            "                    |  Transmit\n"
+            " face |bytes    packets errs drop fifo frame compressed multicast|bytes    "
+            "packets errs drop fifo colls carrier compressed\n";
+        for (int i = 0; i < interfaces; ++i) {
+            std::string name = interfaceName(i);
+            text += std::string(16 - name.size(), ' ') + name +
+                    ": 1827364512 1827364    0    3    0     0          0         0 "
+                    "918273645  918273    0    0    0     0       0          0\n";
+        }
+        std::ofstream(file) << text;
+    }
+
+    void appendAttr(std::string& msg,
+                    unsigned short type,
+                    const void* data,
+                    std::size_t size) {
+        rtattr rta{};
+        rta.rta_len = static_cast<unsigned short>(RTA_LENGTH(size));
+        rta.rta_type = type;
+        msg.append(reinterpret_cast<const char*>(&rta), sizeof(rta));
+        msg.append(static_cast<const char*>(data), size);
+        msg.append(RTA_ALIGN(size) - size, '\0');
+    }
+
+    // recv() chunks of a link dump as the kernel sends them, about 1.4 KB per
+    // interface once all the attributes we ignore are counted
+    std::vector<std::string> linkDumpChunks(int interfaces, uint32_t seq) {
+        std::vector<std::string> chunks(1);
+        const std::string ignored(1300, '\0');
+
+        for (int i = 0; i <= interfaces; ++i) {
+            std::string msg(NLMSG_LENGTH(sizeof(ifinfomsg)), '\0');
+            if (i < interfaces) {
+                std::string name = interfaceName(i);
+                rtnl_link_stats64 stats{};
+                stats.rx_bytes = 1827364512ull * i;
+                stats.tx_bytes = 918273645ull * i;
+
+                appendAttr(msg, IFLA_IFNAME, name.c_str(), name.size() + 1);
+                appendAttr(msg, IFLA_AF_SPEC, ignored.data(), ignored.size());
+                appendAttr(msg, IFLA_STATS64, &stats, sizeof(stats));
+            }
+
+            auto* nh = reinterpret_cast<nlmsghdr*>(msg.data());
+            nh->nlmsg_len = static_cast<uint32_t>(msg.size());
+            nh->nlmsg_type = i < interfaces ? RTM_NEWLINK : NLMSG_DONE;
+            nh->nlmsg_flags = NLM_F_MULTI;
+            nh->nlmsg_seq = seq;
+            reinterpret_cast<ifinfomsg*>(NLMSG_DATA(nh))->ifi_index = i + 1;
+
+            // The kernel fills roughly one 32 KB skb per recv()
+            if (chunks.back().size() + msg.size() > 32 * 1024)
+                chunks.emplace_back();
+            chunks.back() += msg;
+        }
+        return chunks;
+    }
+}  // namespace
+
+// /proc/net/dev read and parse with range(0) interfaces. On a real host the kernel also
+// has to format the text, which this fixture file does not pay for.
+static void BM_ProcNetDevParse(benchmark::State& state) {
+    bench::TempDir dir("net");
+    writeNetDev(dir.path() / "dev", static_cast<int>(state.range(0)));
+
+    ProcFile file((dir.path() / "dev").string());
+    std::vector<NetDevCounters> counters;
+    for (auto _ : state) {
+        parseNetDev(file.read(), counters);
+        benchmark::DoNotOptimize(counters.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ProcNetDevParse)->Arg(8)->Arg(500);
+
+// Decoding the RTM_GETLINK dump of range(0) interfaces, what NetInfo pays after recv()
+static void BM_RtnlParseLinks(benchmark::State& state) {
+    const auto chunks = linkDumpChunks(static_cast<int>(state.range(0)), 1);
+
+    std::vector<LinkSample> links;
+    for (auto _ : state) {
+        links.clear();
+        for (const std::string& chunk : chunks) {
+            rtnl::parseLinks(chunk.data(), chunk.size(), 1, links);
+        }
+        benchmark::DoNotOptimize(links.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RtnlParseLinks)->Arg(8)->Arg(500);
+
+// Both paths end to end against the interfaces of the machine running the benchmark
+static void BM_ProcNetDevLive(benchmark::State& state) {
+    ProcFile file("/proc/net/dev");
+    std::vector<NetDevCounters> counters;
+    for (auto _ : state) {
+        parseNetDev(file.read(), counters);
+        benchmark::DoNotOptimize(counters.data());
+    }
+    state.counters["interfaces"] = static_cast<double>(counters.size());
+}
+BENCHMARK(BM_ProcNetDevLive);
+
+static void BM_LinkDumpLive(benchmark::State& state) {
+    LinkDump dump;
+    std::vector<LinkSample> links;
+    for (auto _ : state) {
+        if (!dump.dump(links)) {
+            state.SkipWithError("RTM_GETLINK dump failed");
+            break;
+        }
+    }
+    state.counters["interfaces"] = static_cast<double>(links.size());
+}
+BENCHMARK(BM_LinkDumpLive);
@@ -0,0 +1,111 @@
+#include <benchmark/benchmark.h>
+#include <fixture.h>
+#include <openssl/ssl.h>
+#include <ticket_keys.h>
+#include <chrono>
+
+namespace {
+    // Client and server of one connection, wired together through a BIO pair so the
+    // handshake runs in-process without sockets
+    class Connection {
+    public:
+        Connection(SSL_CTX* clientCtx, SSL_CTX* serverCtx)
+            : client_(SSL_new(clientCtx)), server_(SSL_new(serverCtx)) {
+            BIO* clientBio = nullptr;
+            BIO* serverBio = nullptr;
+            BIO_new_bio_pair(&clientBio, 0, &serverBio, 0);
+            SSL_set_bio(client_, clientBio, clientBio);
+            SSL_set_bio(server_, serverBio, serverBio);
+            SSL_set_connect_state(client_);
+            SSL_set_accept_state(server_);
+        }
+
+        ~Connection() {
+            // Without a clean shutdown OpenSSL marks the session as not resumable
+            SSL_shutdown(client_);
+            SSL_shutdown(server_);
+            SSL_free(client_);
+            SSL_free(server_);
+        }
+
+        Connection(const Connection&) = delete;
+        Connection& operator=(const Connection&) = delete;
+
+        bool handshake() {
+            for (int round = 0; round < 16; ++round) {
+                int c = SSL_do_handshake(client_);
+                int s = SSL_do_handshake(server_);
+                if (c == 1 && s == 1) {
+                    // TLS 1.3 tickets follow the handshake, let the client take them
+                    char byte;
+                    SSL_read(client_, &byte, 1);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        SSL* client() { return client_; }
+
+    private:
+        SSL* client_;
+        SSL* server_;
+    };
+}  // namespace
+
+// Full handshakes vs. ticket resumption against a server context set up like the
+// server's loops, with TicketKeyStore installed. range(0) is the TLS version,
+// range(1) whether the client offers a ticket.
+static void BM_TlsHandshake(benchmark::State& state) {
+    const int version = static_cast<int>(state.range(0));
+    const bool resume = state.range(1) != 0;
+
+    bench::TempDir dir("tls");
+    bench::Certificate cert = bench::writeCertificate(dir.path());
+    TicketKeyStore ticketKeys((dir.path() / "ticket_keys.bin").string(),
+                              std::chrono::hours(12));
+
+    SSL_CTX* serverCtx = SSL_CTX_new(TLS_server_method());
+    SSL_CTX_use_certificate_file(serverCtx, cert.certFile.c_str(), SSL_FILETYPE_PEM);
+    SSL_CTX_use_PrivateKey_file(serverCtx, cert.keyFile.c_str(), SSL_FILETYPE_PEM);
+    SSL_CTX_set_min_proto_version(serverCtx, version);
+    SSL_CTX_set_max_proto_version(serverCtx, version);
+    ticketKeys.install(serverCtx);
+
+    SSL_CTX* clientCtx = SSL_CTX_new(TLS_client_method());
+    SSL_CTX_set_verify(clientCtx, SSL_VERIFY_NONE, nullptr);
+
+    SSL_SESSION* session = nullptr;
+    {
+        Connection first(clientCtx, serverCtx);
+        if (!first.handshake()) {
+            state.SkipWithError("Handshake failed");
+        } else {
+            session = SSL_get1_session(first.client());
+        }
+    }
+
+    int64_t reused = 0;
+    for (auto _ : state) {
+        Connection conn(clientCtx, serverCtx);
+        if (resume)
+            SSL_set_session(conn.client(), session);
+        if (!conn.handshake()) {
+            state.SkipWithError("Handshake failed");
+            break;
+        }
+        reused += SSL_session_reused(conn.client());
+    }
+
+    state.SetLabel(version == TLS1_3_VERSION ? "TLSv1.3" : "TLSv1.2");
+    state.SetItemsProcessed(state.iterations());
+    state.counters["resumed"] =
+        state.iterations() ? static_cast<double>(reused) / state.iterations() : 0;
+
+    SSL_SESSION_free(session);
+    SSL_CTX_free(clientCtx);
+    SSL_CTX_free(serverCtx);
+}
+BENCHMARK(BM_TlsHandshake)
+    ->ArgsProduct({{TLS1_2_VERSION, TLS1_3_VERSION}, {0, 1}})
+    ->ArgNames({"version", "resume"});
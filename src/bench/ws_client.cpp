@@ -0,0 +1,189 @@
+#include <arpa/inet.h>
+#include <auth.h>
+#include <netdb.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <ws_client.h>
+#include <json.hpp>
+
+namespace bench {
+    namespace {
+        constexpr unsigned char kOpText = 0x1;
+        constexpr unsigned char kOpBinary = 0x2;
+        constexpr unsigned char kOpClose = 0x8;
+    }  // namespace
+
+    WsClient::WsClient() : ctx_(SSL_CTX_new(TLS_client_method())) {
+        SSL_CTX_set_verify(ctx_, SSL_VERIFY_NONE, nullptr);
+    }
+
+    WsClient::~WsClient() {
+        if (ssl_) {
+            SSL_shutdown(ssl_);
+            SSL_free(ssl_);
+        }
+        if (fd_ >= 0)
+            close(fd_);
+        SSL_CTX_free(ctx_);
+    }
+
+    bool WsClient::connect(const std::string& host, int port) {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        addrinfo* result = nullptr;
+        if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result) != 0)
+            return false;
+
+        for (addrinfo* ai = result; ai && fd_ < 0; ai = ai->ai_next) {
+            fd_ = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd_ >= 0 && ::connect(fd_, ai->ai_addr, ai->ai_addrlen) != 0) {
+                close(fd_);
+                fd_ = -1;
+            }
+        }
+        freeaddrinfo(result);
+        if (fd_ < 0)
+            return false;
+
+        int one = 1;
+        setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        ssl_ = SSL_new(ctx_);
+        SSL_set_fd(ssl_, fd_);
+        if (SSL_connect(ssl_) != 1)
+            return false;
+
+        std::string request = "GET / HTTP/1.1\r\nHost: " + host + ":" +
+                              std::to_string(port) +
+                              "\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                              "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                              "Sec-WebSocket-Version: 13\r\n\r\n";
+        if (!writeAll(request.data(), request.size()))
+            return false;
+
+        // Byte at a time up to the blank line, so no frame bytes are consumed
+        std::string response;
+        while (!response.ends_with("\r\n\r\n")) {
+            char c;
+            if (!readExact(&c, 1))
+                return false;
+            response += c;
+        }
+
+        return response.starts_with("HTTP/1.1 101");
+    }
+
+    bool WsClient::authenticate(const std::string& user, const std::string& key) {
+        std::optional<std::string> challenge = read();
+        if (!challenge)
+            return false;
+
+        auto nonce = nlohmann::json::parse(*challenge, nullptr, false);
+        if (!nonce.is_object() || !nonce.contains("nonce"))
+            return false;
+
+        message::AuthResponse response(
+            user + "_" + auth::hmacSha256(key, nonce["nonce"].get<std::string>()));
+        if (!sendText(nlohmann::json(response).dump()))
+            return false;
+
+        std::optional<std::string> result = read();
+        if (!result)
+            return false;
+
+        auto j = nlohmann::json::parse(*result, nullptr, false);
+        return j.is_object() && j.value("success", false);
+    }
+
+    bool WsClient::sendText(std::string_view payload) {
+        // Client frames must be masked, an all-zero key leaves the payload as is
+        std::string frame;
+        frame += static_cast<char>(0x80 | kOpText);
+        if (payload.size() < 126) {
+            frame += static_cast<char>(0x80 | payload.size());
+        } else if (payload.size() <= 0xFFFF) {
+            frame += static_cast<char>(0x80 | 126);
+            frame += static_cast<char>(payload.size() >> 8);
+            frame += static_cast<char>(payload.size() & 0xFF);
+        } else {
+            frame += static_cast<char>(0x80 | 127);
+            for (int shift = 56; shift >= 0; shift -= 8) {
+                frame += static_cast<char>((payload.size() >> shift) & 0xFF);
+            }
+        }
+        frame.append(4, '\0');
+        frame += payload;
+
+        return writeAll(frame.data(), frame.size());
+    }
+
+    std::optional<std::string> WsClient::read() {
+        while (true) {
+            unsigned char header[2];
+            if (!readExact(header, sizeof(header)))
+                return std::nullopt;
+
+            const unsigned char opCode = header[0] & 0x0F;
+            uint64_t length = header[1] & 0x7F;
+            if (length >= 126) {
+                unsigned char extended[8];
+                const std::size_t bytes = length == 126 ? 2 : 8;
+                if (!readExact(extended, bytes))
+                    return std::nullopt;
+                length = 0;
+                for (std::size_t i = 0; i < bytes; ++i) {
+                    length = length << 8 | extended[i];
+                }
+            }
+
+            unsigned char mask[4] = {0, 0, 0, 0};
+            if ((header[1] & 0x80) && !readExact(mask, sizeof(mask)))
+                return std::nullopt;
+
+            std::string payload(length, '\0');
+            if (!readExact(payload.data(), payload.size()))
+                return std::nullopt;
+            for (std::size_t i = 0; i < payload.size(); ++i) {
+                payload[i] ^= static_cast<char>(mask[i % 4]);
+            }
+
+            if (opCode == kOpClose)
+                return std::nullopt;
+            if (opCode == kOpText || opCode == kOpBinary)
+                return payload;
+            // Ping and pong carry nothing for us
+        }
+    }
+
+    void WsClient::shutdown() {
+        if (fd_ >= 0)
+            ::shutdown(fd_, SHUT_RDWR);
+    }
+
+    bool WsClient::readExact(void* data, std::size_t size) {
+        auto* p = static_cast<char*>(data);
+        while (size > 0) {
+            int n = SSL_read(ssl_, p, static_cast<int>(size));
+            if (n <= 0)
+                return false;
+            p += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    bool WsClient::writeAll(const void* data, std::size_t size) {
+        auto* p = static_cast<const char*>(data);
+        while (size > 0) {
+            int n = SSL_write(ssl_, p, static_cast<int>(size));
+            if (n <= 0)
+                return false;
+            p += n;
+            size -= n;
+        }
+        return true;
+    }
+}  // namespace bench
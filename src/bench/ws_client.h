@@ -0,0 +1,45 @@
+#ifndef BENCH_WS_CLIENT_H
+#define BENCH_WS_CLIENT_H
+
+#include <openssl/ssl.h>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace bench {
+    // Minimal blocking TLS websocket client, just enough to authenticate against the
+    // server and read its frames: no extensions, no fragmentation, no certificate
+    // verification
+    class WsClient {
+    public:
+        WsClient();
+        ~WsClient();
+
+        WsClient(const WsClient&) = delete;
+        WsClient& operator=(const WsClient&) = delete;
+
+        bool connect(const std::string& host, int port);
+
+        // AUTH_CHALLENGE / AUTH_RESPONSE / AUTH_RESULT with the given API key
+        bool authenticate(const std::string& user, const std::string& key);
+
+        bool sendText(std::string_view payload);
+
+        // Payload of the next data frame, nullopt once the connection is gone
+        std::optional<std::string> read();
+
+        // Unblocks a read() in progress on another thread
+        void shutdown();
+
+    private:
+        bool readExact(void* data, std::size_t size);
+        bool writeAll(const void* data, std::size_t size);
+
+        SSL_CTX* ctx_ = nullptr;
+        SSL* ssl_ = nullptr;
+        int fd_ = -1;
+    };
+}  // namespace bench
+
+#endif  // BENCH_WS_CLIENT_H
@@ -9,7 +9,15 @@
 #include <fstream>
 #include <paths.hpp>
 #include "cpu.h"
+#include "disk.h"
+#include "heavy_executor.h"
+#include "history_store.h"
+#include "mem.h"
+#include "net.h"
+#include "process.h"
+#include "rollup.h"
 #include "scheduler.h"
+#include "self_stats.h"
 #include "system.h"
 
 std::atomic<bool> running{true};       // Main loop control
@@ -53,20 +61,59 @@ void daemon() {
         .cert_file_name = "../../test/ssl/certs/server.crt",
     };
 
-    Server server(sslOptions, keystore, eventBus);
+    // Metrics repeat the same keys every tick, a per-socket window compresses them well
+    Server server(sslOptions, keystore, eventBus,
+                  {.threads = std::max(1u, std::thread::hardware_concurrency() / 2),
+                   .compression = uWS::DEDICATED_COMPRESSOR_4KB,
+                   .ticketKeysFile = paths::ticketKeysFile()});
 
     // Initialize modules
     SystemInfo sysInfo(eventBus, std::chrono::seconds(1));
     CPUInfo cpuInfo(eventBus, std::chrono::seconds(1));
-
-    // Initialize scheduler for light tasks
-    Scheduler scheduler;
+    MemInfo memInfo(eventBus, std::chrono::seconds(1));
+    DiskInfo diskInfo(eventBus, std::chrono::seconds(1));
+    // Container veth pairs would repeat the traffic of the bridge they hang off
+    NetInfo netInfo(eventBus, std::chrono::seconds(1), {.exclude = {"lo", "veth*"}});
+    SelfStats selfStats(eventBus, std::chrono::seconds(5));
+    ProcessTable processTable(eventBus, std::chrono::seconds(2));
+
+    // Recent samples for dashboards that just connected, a day of them on disk
+    Journal journal(eventBus, paths::journalDir());
+    HistoryStore history(eventBus, std::chrono::minutes(30), std::chrono::seconds(1));
+    history.setJournal(&journal);
+    server.setHistoryStore(&history);
+
+    // 10 s / 1 min / 5 min CPU_ROLLUP summaries for long-range charts
+    RollupAggregator rollups(eventBus);
+
+    // Initialize scheduler for light tasks. Until the first client subscribes it only
+    // runs every 10th tick, enough to keep the history warm.
+    Scheduler scheduler(std::thread::hardware_concurrency(), 10);
+    scheduler.setIdle(true);
     scheduler.add(&sysInfo);
     scheduler.add(&cpuInfo);
+    scheduler.add(&memInfo);
+    scheduler.add(&diskInfo);
+    scheduler.add(&netInfo);
+    scheduler.add(&selfStats);
+
+    // Process scans and other expensive collectors get idle-priority threads of their
+    // own. Nobody looks at the process table while no client is connected, so it just
+    // pauses. 25 ms of CPU per 2 s pass caps the scan at about 1% of a core.
+    HeavyExecutor heavy;
+    heavy.setIdle(true);
+    heavy.add(&processTable, std::chrono::milliseconds(25));
+
+    server.onListenersChanged([&scheduler, &heavy](bool listening) {
+        scheduler.setIdle(!listening);
+        heavy.setIdle(!listening);
+    });
 
     // Add static resources
     server.addStaticResource(&sysInfo);
     server.addStaticResource(&cpuInfo);
+    server.addStaticResource(&memInfo);
+    server.addStaticResource(&diskInfo);
 
     // Run servers
     server.run(9001);
@@ -75,6 +122,7 @@ void daemon() {
     scheduler.start();
 
     // Start heavy tasks
+    heavy.start();
 
     while (running) {
         // Sleep for a short duration to avoid busy waiting
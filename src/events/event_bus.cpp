@@ -2,18 +2,17 @@
 #include <vector>
 
 void EventBus::subscribe(const Handler& handler) {
-    std::lock_guard lk(mutex_);
-    handlers_.push_back(std::move(handler));
+    std::lock_guard lk(writeMutex_);
+
+    auto next = std::make_shared<HandlerList>(*handlers_.load());
+    next->push_back(handler);
+    handlers_.store(std::move(next));
 }
 
 void EventBus::publish(const message::MessageVariantOUT& msg) {
-    std::vector<Handler> handlersCopy;
-    {
-        std::lock_guard lk(mutex_);
-        handlersCopy = handlers_;
-    }
+    std::shared_ptr<const HandlerList> handlers = handlers_.load();
 
-    for (const auto& handler : handlersCopy) {
+    for (const auto& handler : *handlers) {
         handler(msg);
     }
-}
\ No newline at end of file
+}
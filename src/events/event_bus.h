@@ -1,8 +1,10 @@
 #ifndef EVENT_BUS_H
 #define EVENT_BUS_H
 
+#include <atomic>
 #include <functional>
 #include <json.hpp>
+#include <memory>
 #include <mutex>
 
 class EventBus {
@@ -14,8 +16,12 @@ public:
     void publish(const message::MessageVariantOUT& msg);
 
 private:
-    std::vector<Handler> handlers_;
-    std::mutex mutex_;
+    using HandlerList = std::vector<Handler>;
+
+    // Publishers read an immutable snapshot; subscribe() copies, appends and swaps it
+    std::atomic<std::shared_ptr<const HandlerList>> handlers_{
+        std::make_shared<const HandlerList>()};
+    std::mutex writeMutex_;
 };
 
-#endif  // EVENT_BUS_H
\ No newline at end of file
+#endif  // EVENT_BUS_H
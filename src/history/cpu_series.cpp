@@ -0,0 +1,105 @@
+#include <cpu_series.h>
+#include <algorithm>
+#include <charconv>
+
+namespace {
+    // Widen through the float's shortest decimal form, so 12.3f goes out as 12.3 and
+    // not as 12.300000190734863
+    double widen(float v) {
+        char buf[32];
+        auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), v);
+
+        double d = v;
+        std::from_chars(buf, end, d);
+        return d;
+    }
+}  // namespace
+
+CpuSeries::CpuSeries(std::size_t capacity)
+    : capacity_(std::max<std::size_t>(capacity, 1)),
+      steady_(capacity_),
+      timestamps_(capacity_),
+      load1_(capacity_),
+      load5_(capacity_),
+      load15_(capacity_),
+      usage_(capacity_),
+      frequency_(capacity_) {}
+
+void CpuSeries::append(int64_t steadyMs, int64_t wallMs, const message::CpuInfo& sample) {
+    // Cores went on/offline: per-core columns no longer line up, start over
+    if (sample.per_core_usage.size() != cores_) {
+        cores_ = sample.per_core_usage.size();
+        perCore_.assign(cores_ * capacity_, 0.0f);
+        head_ = 0;
+        size_ = 0;
+    }
+
+    steady_[head_] = steadyMs;
+    timestamps_[head_] = wallMs;
+    load1_[head_] = static_cast<float>(sample.cpu_load_avg_1min);
+    load5_[head_] = static_cast<float>(sample.cpu_load_avg_5min);
+    load15_[head_] = static_cast<float>(sample.cpu_load_avg_15min);
+    usage_[head_] = static_cast<float>(sample.cpu_usage);
+    frequency_[head_] = sample.cpu_frequency;
+
+    for (std::size_t core = 0; core < cores_; ++core) {
+        perCore_[core * capacity_ + head_] =
+            static_cast<float>(sample.per_core_usage[core]);
+    }
+
+    head_ = (head_ + 1) % capacity_;
+    size_ = std::min(size_ + 1, capacity_);
+}
+
+message::CpuHistory CpuSeries::since(int64_t fromMs) const {
+    // Steady time only grows, binary search for the first sample inside the window.
+    // Wall time can step back and would break the ordering.
+    std::size_t first = 0;
+    std::size_t count = size_;
+    while (count > 0) {
+        std::size_t step = count / 2;
+        if (steady_[slot(first + step)] < fromMs) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+
+    const std::size_t n = size_ - first;
+
+    message::CpuHistory history;
+    history.timestamps.reserve(n);
+    history.cpu_load_avg_1min.reserve(n);
+    history.cpu_load_avg_5min.reserve(n);
+    history.cpu_load_avg_15min.reserve(n);
+    history.cpu_usage.reserve(n);
+    history.cpu_frequency.reserve(n);
+    history.per_core_usage.assign(cores_, {});
+
+    for (std::size_t i = first; i < size_; ++i) {
+        const std::size_t s = slot(i);
+        history.timestamps.push_back(timestamps_[s]);
+        history.cpu_load_avg_1min.push_back(widen(load1_[s]));
+        history.cpu_load_avg_5min.push_back(widen(load5_[s]));
+        history.cpu_load_avg_15min.push_back(widen(load15_[s]));
+        history.cpu_usage.push_back(widen(usage_[s]));
+        history.cpu_frequency.push_back(frequency_[s]);
+    }
+
+    for (std::size_t core = 0; core < cores_; ++core) {
+        auto& column = history.per_core_usage[core];
+        column.reserve(n);
+
+        const float* values = perCore_.data() + core * capacity_;
+        for (std::size_t i = first; i < size_; ++i) {
+            column.push_back(widen(values[slot(i)]));
+        }
+    }
+
+    return history;
+}
+
+std::size_t CpuSeries::slot(std::size_t n) const {
+    return (head_ + capacity_ - size_ + n) % capacity_;
+}
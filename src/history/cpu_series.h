@@ -0,0 +1,43 @@
+#ifndef CPU_SERIES_H
+#define CPU_SERIES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <json.hpp>
+#include <vector>
+
+// Fixed-capacity ring of CpuInfo samples stored column by column as floats, so a
+// replay walks contiguous arrays instead of chasing one vector per sample
+class CpuSeries {
+public:
+    explicit CpuSeries(std::size_t capacity);
+
+    // steadyMs orders the samples, wallMs is only what clients get to display
+    void append(int64_t steadyMs, int64_t wallMs, const message::CpuInfo& sample);
+
+    // Samples taken at or after steady time fromMs, oldest first
+    message::CpuHistory since(int64_t fromMs) const;
+
+    std::size_t size() const { return size_; }
+    std::size_t capacity() const { return capacity_; }
+
+private:
+    // Slot of the n-th oldest sample
+    std::size_t slot(std::size_t n) const;
+
+    std::size_t capacity_;
+    std::size_t head_ = 0;  // Next slot to write
+    std::size_t size_ = 0;
+    std::size_t cores_ = 0;
+
+    std::vector<int64_t> steady_;
+    std::vector<int64_t> timestamps_;
+    std::vector<float> load1_;
+    std::vector<float> load5_;
+    std::vector<float> load15_;
+    std::vector<float> usage_;
+    std::vector<int32_t> frequency_;
+    std::vector<float> perCore_;  // Core-major: perCore_[core * capacity_ + slot]
+};
+
+#endif  // CPU_SERIES_H
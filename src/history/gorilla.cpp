@@ -0,0 +1,129 @@
+#include <gorilla.h>
+#include <bit>
+
+namespace gorilla {
+    namespace {
+        int64_t signExtend(uint64_t value, int bits) {
+            const uint64_t sign = uint64_t{1} << (bits - 1);
+            return static_cast<int64_t>((value ^ sign) - sign);
+        }
+    }  // namespace
+
+    void TimestampEncoder::encode(BitWriter& out, int64_t timestamp) {
+        if (first_) {
+            out.write(static_cast<uint64_t>(timestamp), 64);
+            previous_ = timestamp;
+            first_ = false;
+            return;
+        }
+
+        const int64_t delta = timestamp - previous_;
+        const int64_t dod = delta - previousDelta_;
+        const auto bits = static_cast<uint64_t>(dod);
+
+        if (dod == 0) {
+            out.write(0b0, 1);
+        } else if (dod >= -64 && dod < 64) {
+            out.write(0b10, 2);
+            out.write(bits, 7);
+        } else if (dod >= -256 && dod < 256) {
+            out.write(0b110, 3);
+            out.write(bits, 9);
+        } else if (dod >= -2048 && dod < 2048) {
+            out.write(0b1110, 4);
+            out.write(bits, 12);
+        } else {
+            out.write(0b1111, 4);
+            out.write(bits, 64);
+        }
+
+        previous_ = timestamp;
+        previousDelta_ = delta;
+    }
+
+    int64_t TimestampDecoder::decode(BitReader& in) {
+        if (first_) {
+            previous_ = static_cast<int64_t>(in.read(64));
+            first_ = false;
+            return previous_;
+        }
+
+        int64_t dod = 0;
+        if (in.read(1) == 0) {
+            dod = 0;
+        } else if (in.read(1) == 0) {
+            dod = signExtend(in.read(7), 7);
+        } else if (in.read(1) == 0) {
+            dod = signExtend(in.read(9), 9);
+        } else if (in.read(1) == 0) {
+            dod = signExtend(in.read(12), 12);
+        } else {
+            dod = static_cast<int64_t>(in.read(64));
+        }
+
+        previousDelta_ += dod;
+        previous_ += previousDelta_;
+        return previous_;
+    }
+
+    void XorEncoder::encode(BitWriter& out, double value) {
+        const auto bits = std::bit_cast<uint64_t>(value);
+
+        if (first_) {
+            out.write(bits, 64);
+            previous_ = bits;
+            first_ = false;
+            return;
+        }
+
+        const uint64_t x = bits ^ previous_;
+        previous_ = bits;
+
+        if (x == 0) {
+            out.write(0b0, 1);
+            return;
+        }
+
+        const int leading = std::min(std::countl_zero(x), 31);
+        const int trailing = std::countr_zero(x);
+
+        // Fits in the previous window: skip re-sending its size
+        if (leading_ >= 0 && leading >= leading_ && trailing >= trailing_) {
+            out.write(0b10, 2);
+            out.write(x >> trailing_, 64 - leading_ - trailing_);
+            return;
+        }
+
+        const int meaningful = 64 - leading - trailing;
+        out.write(0b11, 2);
+        out.write(leading, 5);
+        out.write(meaningful & 63, 6);  // 64 doesn't fit in 6 bits, stored as 0
+        out.write(x >> trailing, meaningful);
+
+        leading_ = leading;
+        trailing_ = trailing;
+    }
+
+    double XorDecoder::decode(BitReader& in) {
+        if (first_) {
+            previous_ = in.read(64);
+            first_ = false;
+            return std::bit_cast<double>(previous_);
+        }
+
+        if (in.read(1) == 0)
+            return std::bit_cast<double>(previous_);
+
+        if (in.read(1) == 1) {
+            leading_ = static_cast<int>(in.read(5));
+            int meaningful = static_cast<int>(in.read(6));
+            if (meaningful == 0)
+                meaningful = 64;
+            // Only a corrupt stream overlaps the window past bit 0
+            trailing_ = std::max(0, 64 - leading_ - meaningful);
+        }
+
+        previous_ ^= in.read(64 - leading_ - trailing_) << trailing_;
+        return std::bit_cast<double>(previous_);
+    }
+}  // namespace gorilla
@@ -0,0 +1,126 @@
+#ifndef GORILLA_H
+#define GORILLA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+// Gorilla-style compression (Pelkonen et al., VLDB 2015): delta-of-delta timestamps
+// and XOR'd doubles, packed MSB-first into caller-owned memory. Regular 1 Hz samples
+// cost one bit per timestamp and unchanged values one bit each.
+namespace gorilla {
+    // Worst-case sizes, used to decide whether another sample still fits
+    inline constexpr std::size_t kMaxTimestampBits = 4 + 64;
+    inline constexpr std::size_t kMaxValueBits = 2 + 5 + 6 + 64;
+
+    // Expects zeroed memory, bits are OR'ed in
+    class BitWriter {
+    public:
+        BitWriter(uint8_t* data, std::size_t bytes, std::size_t position = 0)
+            : data_(data), capacity_(bytes * 8), position_(position) {}
+
+        // Low `bits` bits of value, most significant first
+        void write(uint64_t value, int bits) {
+            while (bits > 0) {
+                const int offset = position_ & 7;
+                const int n = std::min(8 - offset, bits);
+                const auto chunk =
+                    static_cast<uint8_t>((value >> (bits - n)) & ((1u << n) - 1));
+
+                data_[position_ >> 3] |= static_cast<uint8_t>(chunk << (8 - offset - n));
+                position_ += n;
+                bits -= n;
+            }
+        }
+
+        std::size_t position() const { return position_; }
+        std::size_t remaining() const { return capacity_ - position_; }
+
+    private:
+        uint8_t* data_;
+        std::size_t capacity_;
+        std::size_t position_;
+    };
+
+    // Never reads past the first `limit` bits. A read that would returns 0 and marks the
+    // reader overrun, so a torn stream ends the decode instead of faulting.
+    class BitReader {
+    public:
+        BitReader(const uint8_t* data, std::size_t limit) : data_(data), limit_(limit) {}
+
+        uint64_t read(int bits) {
+            if (bits < 0 || bits > 64 ||
+                limit_ - position_ < static_cast<std::size_t>(bits)) {
+                overrun_ = true;
+                position_ = limit_;
+                return 0;
+            }
+
+            uint64_t value = 0;
+            while (bits > 0) {
+                const int offset = position_ & 7;
+                const int n = std::min(8 - offset, bits);
+                const uint8_t chunk =
+                    (data_[position_ >> 3] >> (8 - offset - n)) & ((1u << n) - 1);
+
+                value = (value << n) | chunk;
+                position_ += n;
+                bits -= n;
+            }
+            return value;
+        }
+
+        std::size_t position() const { return position_; }
+        bool overrun() const { return overrun_; }
+
+    private:
+        const uint8_t* data_;
+        std::size_t limit_;
+        std::size_t position_ = 0;
+        bool overrun_ = false;
+    };
+
+    class TimestampEncoder {
+    public:
+        void encode(BitWriter& out, int64_t timestamp);
+
+    private:
+        bool first_ = true;
+        int64_t previous_ = 0;
+        int64_t previousDelta_ = 0;
+    };
+
+    class TimestampDecoder {
+    public:
+        int64_t decode(BitReader& in);
+
+    private:
+        bool first_ = true;
+        int64_t previous_ = 0;
+        int64_t previousDelta_ = 0;
+    };
+
+    class XorEncoder {
+    public:
+        void encode(BitWriter& out, double value);
+
+    private:
+        bool first_ = true;
+        uint64_t previous_ = 0;
+        int leading_ = -1;  // Window of the last explicitly sized XOR, -1 before one
+        int trailing_ = 0;
+    };
+
+    class XorDecoder {
+    public:
+        double decode(BitReader& in);
+
+    private:
+        bool first_ = true;
+        uint64_t previous_ = 0;
+        int leading_ = 0;
+        int trailing_ = 0;
+    };
+}  // namespace gorilla
+
+#endif  // GORILLA_H
@@ -0,0 +1,54 @@
+#include <history_store.h>
+
+HistoryStore::HistoryStore(EventBus& eventBus,
+                           std::chrono::seconds retention,
+                           std::chrono::milliseconds interval)
+    : retention_(retention),
+      cpu_(retention / std::max(interval, std::chrono::milliseconds(1))) {
+    eventBus.subscribe([this](const message::MessageVariantOUT& msg) { record(msg); });
+}
+
+bool HistoryStore::recorded(message::Type type) {
+    return type == message::Type::CPU_INFO;
+}
+
+void HistoryStore::setJournal(Journal* journal) {
+    journal_ = journal;
+}
+
+std::chrono::seconds HistoryStore::retention() const {
+    return journal_ ? std::max(retention_, journal_->retention()) : retention_;
+}
+
+message::CpuHistory HistoryStore::cpu(std::chrono::seconds window) {
+    const int64_t windowMs = std::chrono::milliseconds(window).count();
+
+    // The journal outlives restarts, so it can only be indexed by wall time
+    if (journal_ && window > retention_)
+        return journal_->cpu(wallMs() - windowMs, kMaxPoints);
+
+    std::lock_guard lk(mutex_);
+    return cpu_.since(steadyMs() - windowMs);
+}
+
+void HistoryStore::record(const message::MessageVariantOUT& msg) {
+    if (const auto* cpu = std::get_if<message::CpuInfo>(&msg)) {
+        const int64_t steady = steadyMs();
+        const int64_t wall = wallMs();
+
+        std::lock_guard lk(mutex_);
+        cpu_.append(steady, wall, *cpu);
+    }
+}
+
+int64_t HistoryStore::steadyMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+int64_t HistoryStore::wallMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
@@ -0,0 +1,48 @@
+#ifndef HISTORY_STORE_H
+#define HISTORY_STORE_H
+
+#include <chrono>
+#include <event_bus.h>
+#include <json.hpp>
+#include <mutex>
+#include "cpu_series.h"
+#include "journal.h"
+
+// Keeps the recent samples of the streamed metrics in memory, so a freshly opened
+// dashboard can fill its charts with one HISTORY_REQUEST instead of waiting.
+// SYSTEM_INFO carries display strings only and has no series worth replaying. Windows
+// longer than the in-memory retention are read from the journal, if one is attached,
+// and averaged down to kMaxPoints.
+class HistoryStore {
+public:
+    // An hour of 1 Hz samples; a day from the journal comes out one point per 24 s
+    static constexpr std::size_t kMaxPoints = 3600;
+
+    HistoryStore(EventBus& eventBus,
+                 std::chrono::seconds retention,
+                 std::chrono::milliseconds interval);
+
+    static bool recorded(message::Type type);
+
+    void setJournal(Journal* journal);
+
+    // Decodes the journal for long windows, keep it off the event loops
+    message::CpuHistory cpu(std::chrono::seconds window);
+
+    // Longest window that can be answered
+    std::chrono::seconds retention() const;
+
+private:
+    void record(const message::MessageVariantOUT& msg);
+
+    static int64_t steadyMs();
+    static int64_t wallMs();
+
+    std::chrono::seconds retention_;
+    Journal* journal_ = nullptr;
+
+    std::mutex mutex_;
+    CpuSeries cpu_;
+};
+
+#endif  // HISTORY_STORE_H
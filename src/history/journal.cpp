@@ -0,0 +1,350 @@
+#include <fcntl.h>
+#include <journal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <print>
+
+namespace {
+    constexpr char kMagic[8] = {'N', 'W', 'J', 'R', 'N', 'L', 'C', 'P'};
+    constexpr uint32_t kVersion = 1;
+
+    // Linux's own CONFIG_NR_CPUS ceiling, a header claiming more is corrupt
+    constexpr uint32_t kMaxCores = 8192;
+
+    int64_t nowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+
+    uint8_t* mapFile(const std::filesystem::path& path, std::size_t size, bool writable) {
+        int fd = ::open(path.c_str(), (writable ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+        if (fd < 0)
+            return nullptr;
+
+        void* data = ::mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                            MAP_SHARED, fd, 0);
+        ::close(fd);
+
+        return data == MAP_FAILED ? nullptr : static_cast<uint8_t*>(data);
+    }
+}  // namespace
+
+Journal::Journal(EventBus& eventBus, std::filesystem::path dir, JournalOptions options)
+    : dir_(std::move(dir)), options_(options) {
+    std::error_code ec;
+    std::filesystem::create_directories(dir_, ec);
+    if (ec)
+        std::print(stderr, "Failed to create journal directory {}: {}\n", dir_.string(),
+                   ec.message());
+
+    loadSegments();
+
+    eventBus.subscribe([this](const message::MessageVariantOUT& msg) {
+        if (const auto* cpu = std::get_if<message::CpuInfo>(&msg))
+            append(nowMs(), *cpu);
+    });
+}
+
+Journal::~Journal() {
+    std::lock_guard lk(mutex_);
+
+    if (active_)
+        sealActive();
+
+    for (Segment& segment : sealed_) {
+        ::munmap(segment.data, segment.size);
+    }
+}
+
+void Journal::append(int64_t timestampMs, const message::CpuInfo& sample) {
+    const auto cores = static_cast<uint32_t>(sample.per_core_usage.size());
+    const std::size_t needed =
+        gorilla::kMaxTimestampBits + columnCount(cores) * gorilla::kMaxValueBits;
+    const int64_t maxAgeMs = std::chrono::milliseconds(options_.segmentAge).count();
+
+    std::lock_guard lk(mutex_);
+
+    // Segment ranges and scans assume time order; the wall clock can step back, so a
+    // sample never goes in before the one written last, even across restarts
+    if (active_)
+        timestampMs = std::max(timestampMs, active_->segment.header().lastMs);
+    else if (!sealed_.empty())
+        timestampMs = std::max(timestampMs, sealed_.back().header().lastMs);
+
+    if (active_) {
+        const Header& header = active_->segment.header();
+        if (header.cores != cores || active_->capacityBits - header.bits < needed ||
+            timestampMs - header.firstMs >= maxAgeMs)
+            sealActive();
+    }
+
+    if (!active_) {
+        dropExpired(timestampMs);
+        if (!openActive(timestampMs, cores))
+            return;
+    }
+
+    Active& active = *active_;
+    auto& header = *reinterpret_cast<Header*>(active.segment.data);
+
+    // Segment configured smaller than a single sample
+    if (active.capacityBits - header.bits < needed)
+        return;
+
+    gorilla::BitWriter out(active.segment.data + sizeof(Header),
+                           active.segment.size - sizeof(Header), header.bits);
+
+    active.timestamps.encode(out, timestampMs);
+    active.columns[0].encode(out, sample.cpu_load_avg_1min);
+    active.columns[1].encode(out, sample.cpu_load_avg_5min);
+    active.columns[2].encode(out, sample.cpu_load_avg_15min);
+    active.columns[3].encode(out, sample.cpu_usage);
+    active.columns[4].encode(out, sample.cpu_frequency);
+    for (uint32_t core = 0; core < cores; ++core) {
+        active.columns[5 + core].encode(out, sample.per_core_usage[core]);
+    }
+
+    // Stream first, then the header that makes it visible
+    header.bits = out.position();
+    header.lastMs = timestampMs;
+    ++header.count;
+}
+
+void Journal::scan(int64_t fromMs,
+                   int64_t toMs,
+                   const std::function<void(const JournalSample&)>& fn) {
+    // Segments may be sealed or dropped between two of them, so pick up the next by
+    // its start time rather than by position. Segment files are named after it, no
+    // two share one.
+    for (int64_t after = std::numeric_limits<int64_t>::min();;) {
+        std::lock_guard lk(mutex_);
+
+        const Segment* next = nullptr;
+        for (const Segment& segment : sealed_) {
+            if (segment.header().firstMs > after) {
+                next = &segment;
+                break;
+            }
+        }
+        if (!next && active_ && active_->segment.header().firstMs > after)
+            next = &active_->segment;
+        if (!next || next->header().firstMs > toMs)
+            return;
+
+        const Header& header = next->header();
+        after = header.firstMs;
+        if (header.lastMs >= fromMs)
+            scanSegment(*next, fromMs, toMs, fn);
+    }
+}
+
+message::CpuHistory Journal::cpu(int64_t fromMs, std::size_t maxPoints) {
+    // A day of 1 Hz samples is a 100 MB frame on a big machine, a chart only needs a
+    // point per step
+    const int64_t spanMs = std::max<int64_t>(nowMs() - fromMs, 1);
+    const auto points = static_cast<int64_t>(std::max<std::size_t>(maxPoints, 1));
+    const int64_t stepMs = (spanMs + points - 1) / points;
+
+    message::CpuHistory history;
+    int64_t step = -1;     // Step of the point being averaged
+    std::size_t n = 0;     // Samples averaged into it so far
+    double frequency = 0;  // Its mean frequency before rounding
+
+    // Running mean, the first sample of a step opens its point
+    auto add = [&](std::vector<double>& column, double value) {
+        if (n == 0)
+            column.push_back(value);
+        else
+            column.back() += (value - column.back()) / static_cast<double>(n + 1);
+    };
+
+    scan(fromMs, std::numeric_limits<int64_t>::max(), [&](const JournalSample& sample) {
+        // Cores went on/offline: per-core columns no longer line up, start over
+        if (sample.perCore.size() != history.per_core_usage.size()) {
+            history = {};
+            history.per_core_usage.resize(sample.perCore.size());
+            step = -1;
+        }
+
+        if (const int64_t s = (sample.timestamp - fromMs) / stepMs; s != step) {
+            step = s;
+            n = 0;
+            history.timestamps.push_back(sample.timestamp);
+            history.cpu_frequency.push_back(0);
+        }
+
+        add(history.cpu_load_avg_1min, sample.loadAvg1);
+        add(history.cpu_load_avg_5min, sample.loadAvg5);
+        add(history.cpu_load_avg_15min, sample.loadAvg15);
+        add(history.cpu_usage, sample.usage);
+        for (std::size_t core = 0; core < sample.perCore.size(); ++core) {
+            add(history.per_core_usage[core], sample.perCore[core]);
+        }
+
+        frequency = n == 0 ? sample.frequency
+                           : frequency + (sample.frequency - frequency) / (n + 1.0);
+        history.cpu_frequency.back() = static_cast<int>(std::lround(frequency));
+        ++n;
+    });
+
+    return history;
+}
+
+int64_t Journal::oldest() {
+    std::lock_guard lk(mutex_);
+
+    if (!sealed_.empty())
+        return sealed_.front().header().firstMs;
+    if (active_ && active_->segment.header().count > 0)
+        return active_->segment.header().firstMs;
+    return -1;
+}
+
+void Journal::loadSegments() {
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(dir_, ec)) {
+        if (entry.path().extension() != ".seg")
+            continue;
+
+        const std::size_t size = entry.file_size(ec);
+        if (ec || size < sizeof(Header))
+            continue;
+
+        Segment segment{entry.path(), mapFile(entry.path(), size, false), size};
+        if (!segment.data)
+            continue;
+
+        // Segments left unsealed by a crash are still valid up to their header count.
+        // The first sample is stored raw, 64 bits per column, and every later one
+        // takes at least a bit per column; a header promising more is torn.
+        const Header& header = segment.header();
+        const uint64_t columns = 1 + columnCount(header.cores);
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+            header.version != kVersion || header.count == 0 ||
+            header.cores > kMaxCores || header.bits > (size - sizeof(Header)) * 8 ||
+            header.bits < 64 * columns ||
+            (header.bits - 64 * columns) / columns < header.count - 1) {
+            ::munmap(segment.data, segment.size);
+            continue;
+        }
+
+        sealed_.push_back(segment);
+    }
+
+    std::ranges::sort(sealed_, {}, [](const Segment& s) { return s.header().firstMs; });
+    dropExpired(nowMs());
+}
+
+bool Journal::openActive(int64_t timestampMs, uint32_t cores) {
+    const auto path = dir_ / ("cpu-" + std::to_string(timestampMs) + ".seg");
+    const std::size_t size = std::max(options_.segmentBytes, sizeof(Header) + 1);
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd < 0 || ::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        if (fd >= 0) {
+            ::close(fd);
+            ::unlink(path.c_str());
+        }
+        std::print(stderr, "Failed to create journal segment {}\n", path.string());
+        return false;
+    }
+    ::close(fd);
+
+    uint8_t* data = mapFile(path, size, true);
+    if (!data) {
+        ::unlink(path.c_str());
+        std::print(stderr, "Failed to map journal segment {}\n", path.string());
+        return false;
+    }
+
+    auto& header = *reinterpret_cast<Header*>(data);
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.cores = cores;
+    header.firstMs = timestampMs;
+    header.lastMs = timestampMs;
+
+    active_.emplace();
+    active_->segment = {path, data, size};
+    active_->capacityBits = (size - sizeof(Header)) * 8;
+    active_->columns.resize(columnCount(cores));
+    return true;
+}
+
+void Journal::sealActive() {
+    Segment segment = active_->segment;
+    active_.reset();
+
+    const Header header = segment.header();
+    ::munmap(segment.data, segment.size);
+
+    if (header.count == 0) {
+        ::unlink(segment.path.c_str());
+        return;
+    }
+
+    // Give back the unused tail and keep the segment mapped read-only
+    const std::size_t used = sizeof(Header) + (header.bits + 7) / 8;
+    if (::truncate(segment.path.c_str(), static_cast<off_t>(used)) == 0)
+        segment.size = used;
+
+    segment.data = mapFile(segment.path, segment.size, false);
+    if (segment.data)
+        sealed_.push_back(segment);
+}
+
+void Journal::dropExpired(int64_t nowMs) {
+    const int64_t cutoff = nowMs - std::chrono::milliseconds(options_.retention).count();
+
+    while (!sealed_.empty() && sealed_.front().header().lastMs < cutoff) {
+        Segment& segment = sealed_.front();
+        ::munmap(segment.data, segment.size);
+        std::filesystem::remove(segment.path);
+        sealed_.erase(sealed_.begin());
+    }
+}
+
+void Journal::scanSegment(const Segment& segment,
+                          int64_t fromMs,
+                          int64_t toMs,
+                          const std::function<void(const JournalSample&)>& fn) {
+    const Header& header = segment.header();
+    const uint64_t count = header.count;
+
+    // Never past the committed bits, nor the mapping if a torn header claims more
+    gorilla::BitReader in(segment.stream(),
+                          std::min<std::size_t>(header.bits,
+                                                (segment.size - sizeof(Header)) * 8));
+    gorilla::TimestampDecoder timestamps;
+    std::vector<gorilla::XorDecoder> columns(columnCount(header.cores));
+    scratch_.resize(header.cores);
+
+    for (uint64_t i = 0; i < count; ++i) {
+        // Every column has to be decoded, each value depends on the previous one
+        JournalSample sample;
+        sample.timestamp = timestamps.decode(in);
+        sample.loadAvg1 = columns[0].decode(in);
+        sample.loadAvg5 = columns[1].decode(in);
+        sample.loadAvg15 = columns[2].decode(in);
+        sample.usage = columns[3].decode(in);
+        sample.frequency = static_cast<int>(columns[4].decode(in));
+        for (uint32_t core = 0; core < header.cores; ++core) {
+            scratch_[core] = columns[5 + core].decode(in);
+        }
+        sample.perCore = scratch_;
+
+        // The stream ends before the header count, drop the rest of the segment
+        if (in.overrun())
+            return;
+
+        if (sample.timestamp >= fromMs && sample.timestamp <= toMs)
+            fn(sample);
+    }
+}
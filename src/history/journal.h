@@ -0,0 +1,110 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <chrono>
+#include <cstdint>
+#include <event_bus.h>
+#include <filesystem>
+#include <functional>
+#include <json.hpp>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+#include "gorilla.h"
+
+// One decoded CpuInfo sample. perCore points into the scanner's scratch space and is
+// only valid during the callback.
+struct JournalSample {
+    int64_t timestamp;  // Milliseconds since the epoch
+    double loadAvg1;
+    double loadAvg5;
+    double loadAvg15;
+    double usage;
+    int frequency;
+    std::span<const double> perCore;
+};
+
+struct JournalOptions {
+    std::size_t segmentBytes = 8 * 1024 * 1024;
+    std::chrono::seconds segmentAge = std::chrono::hours(1);
+    std::chrono::seconds retention = std::chrono::hours(24);
+};
+
+// Append-only CpuInfo journal on memory-mapped segment files. Each segment is a
+// Gorilla bit stream: delta-of-delta timestamps, then every value column XOR'd against
+// its previous sample. Segments rotate by size and age, and are dropped after the
+// retention period. Scans decode straight from the mapped pages.
+class Journal {
+public:
+    Journal(EventBus& eventBus, std::filesystem::path dir, JournalOptions options = {});
+    ~Journal();
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    void append(int64_t timestampMs, const message::CpuInfo& sample);
+
+    // Calls fn for every sample in [fromMs, toMs], oldest first. The lock is taken
+    // per segment, appends only ever wait for one segment to be decoded.
+    void scan(int64_t fromMs,
+              int64_t toMs,
+              const std::function<void(const JournalSample&)>& fn);
+
+    // Samples since fromMs, consecutive ones averaged down to at most maxPoints
+    message::CpuHistory cpu(int64_t fromMs, std::size_t maxPoints);
+
+    std::chrono::seconds retention() const { return options_.retention; }
+
+    // Oldest sample still on disk, or -1 when empty
+    int64_t oldest();
+
+private:
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t cores;
+        int64_t firstMs;
+        int64_t lastMs;
+        uint64_t count;
+        uint64_t bits;  // Committed length of the bit stream
+    };
+
+    struct Segment {
+        std::filesystem::path path;
+        uint8_t* data = nullptr;
+        std::size_t size = 0;
+
+        const Header& header() const { return *reinterpret_cast<const Header*>(data); }
+        const uint8_t* stream() const { return data + sizeof(Header); }
+    };
+
+    // Encoder state of the segment being written
+    struct Active {
+        Segment segment;
+        std::size_t capacityBits = 0;
+        gorilla::TimestampEncoder timestamps;
+        std::vector<gorilla::XorEncoder> columns;
+    };
+
+    void loadSegments();
+    bool openActive(int64_t timestampMs, uint32_t cores);
+    void sealActive();
+    void dropExpired(int64_t nowMs);
+    void scanSegment(const Segment& segment,
+                     int64_t fromMs,
+                     int64_t toMs,
+                     const std::function<void(const JournalSample&)>& fn);
+
+    static std::size_t columnCount(uint32_t cores) { return 5 + cores; }
+
+    std::filesystem::path dir_;
+    JournalOptions options_;
+
+    std::mutex mutex_;
+    std::vector<Segment> sealed_;  // Read-only, oldest first
+    std::optional<Active> active_;
+    std::vector<double> scratch_;
+};
+
+#endif  // JOURNAL_H
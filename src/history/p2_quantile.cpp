@@ -0,0 +1,101 @@
+#include <p2_quantile.h>
+#include <algorithm>
+#include <cmath>
+
+P2Quantile::P2Quantile(double p) : p_(p) {
+    reset();
+}
+
+void P2Quantile::reset() {
+    count_ = 0;
+}
+
+void P2Quantile::add(double x) {
+    if (count_ < kExact) {
+        samples_[count_++] = x;
+        return;
+    }
+    if (count_ == kExact)
+        seed();
+    ++count_;
+
+    int k;
+    if (x < heights_[0]) {
+        heights_[0] = x;
+        k = 0;
+    } else if (x >= heights_[4]) {
+        heights_[4] = x;
+        k = 3;
+    } else {
+        k = 0;
+        while (x >= heights_[k + 1])
+            ++k;
+    }
+
+    for (int i = k + 1; i < 5; ++i) {
+        positions_[i] += 1;
+    }
+    for (int i = 0; i < 5; ++i) {
+        desired_[i] += increments_[i];
+    }
+
+    // Move the middle markers back towards their desired positions
+    for (int i = 1; i < 4; ++i) {
+        const double d = desired_[i] - positions_[i];
+        if ((d >= 1 && positions_[i + 1] - positions_[i] > 1) ||
+            (d <= -1 && positions_[i - 1] - positions_[i] < -1)) {
+            const int step = d > 0 ? 1 : -1;
+            const double h = parabolic(i, step);
+
+            heights_[i] =
+                heights_[i - 1] < h && h < heights_[i + 1] ? h : linear(i, step);
+            positions_[i] += step;
+        }
+    }
+}
+
+double P2Quantile::value() const {
+    if (count_ > kExact)
+        return heights_[2];
+    if (count_ == 0)
+        return 0;
+
+    // Nearest-rank over the kept samples
+    std::array<double, kExact> sorted = samples_;
+    std::sort(sorted.begin(), sorted.begin() + count_);
+    const auto rank = static_cast<std::size_t>(std::ceil(p_ * count_));
+    return sorted[std::clamp<std::size_t>(rank, 1, count_) - 1];
+}
+
+void P2Quantile::seed() {
+    std::sort(samples_.begin(), samples_.end());
+
+    // Markers at the min, p/2, p, (1+p)/2 and max ranks of the kept samples
+    const double last = kExact - 1;
+    increments_ = {0, p_ / 2, p_, (1 + p_) / 2, 1};
+    for (int i = 0; i < 5; ++i) {
+        desired_[i] = last * increments_[i];
+        positions_[i] = std::floor(desired_[i]);
+        heights_[i] = samples_[static_cast<std::size_t>(positions_[i])];
+    }
+
+    // Middle markers must sit strictly between their neighbours
+    for (int i = 1; i < 4; ++i) {
+        positions_[i] = std::clamp(positions_[i], positions_[i - 1] + 1, last - (4 - i));
+        heights_[i] = samples_[static_cast<std::size_t>(positions_[i])];
+    }
+}
+
+double P2Quantile::parabolic(int i, double d) const {
+    const auto& q = heights_;
+    const auto& n = positions_;
+
+    return q[i] + d / (n[i + 1] - n[i - 1]) *
+                      ((n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i]) +
+                       (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+}
+
+double P2Quantile::linear(int i, int d) const {
+    return heights_[i] +
+           d * (heights_[i + d] - heights_[i]) / (positions_[i + d] - positions_[i]);
+}
@@ -0,0 +1,36 @@
+#ifndef P2_QUANTILE_H
+#define P2_QUANTILE_H
+
+#include <array>
+#include <cstddef>
+
+// P² streaming quantile estimator (Jain & Chlamtac, 1985). Five markers track the
+// quantile, O(1) time and memory per sample and no stored observations. P² is poor on
+// a handful of samples, so the first kExact are kept and ranked exactly, then seed the
+// markers.
+class P2Quantile {
+public:
+    static constexpr std::size_t kExact = 16;
+
+    explicit P2Quantile(double p);
+
+    void add(double x);
+    double value() const;
+    void reset();
+
+private:
+    void seed();
+    double parabolic(int i, double d) const;
+    double linear(int i, int d) const;
+
+    double p_;
+    std::size_t count_ = 0;
+    std::array<double, kExact> samples_{};
+
+    std::array<double, 5> heights_{};
+    std::array<double, 5> positions_{};
+    std::array<double, 5> desired_{};
+    std::array<double, 5> increments_{};
+};
+
+#endif  // P2_QUANTILE_H
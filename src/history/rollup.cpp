@@ -0,0 +1,106 @@
+#include <rollup.h>
+#include <algorithm>
+
+RollupAggregator::RollupAggregator(EventBus& eventBus,
+                                   std::vector<std::chrono::seconds> windows)
+    : eventBus_(eventBus) {
+    for (auto length : windows) {
+        windows_.push_back(Window{std::max(length, std::chrono::seconds(1))});
+    }
+
+    eventBus_.subscribe([this](const message::MessageVariantOUT& msg) {
+        if (const auto* cpu = std::get_if<message::CpuInfo>(&msg)) {
+            add(std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::system_clock::now().time_since_epoch())
+                    .count(),
+                *cpu);
+        }
+    });
+}
+
+void RollupAggregator::add(int64_t timestampMs, const message::CpuInfo& sample) {
+    const std::size_t cores = sample.per_core_usage.size();
+    std::vector<message::CpuRollup> closed;
+
+    {
+        std::lock_guard lk(mutex_);
+
+        for (Window& window : windows_) {
+            const int64_t lengthMs = std::chrono::milliseconds(window.length).count();
+            const int64_t start = timestampMs - timestampMs % lengthMs;
+
+            // The first sample past a window closes it
+            if (window.startMs != start) {
+                if (window.samples > 0)
+                    closed.push_back(window.close());
+                window.reset(start, cores);
+            } else if (window.perCore.size() != cores) {
+                // Cores went on/offline mid-window, their columns start over
+                window.perCore.assign(cores, {});
+            }
+
+            ++window.samples;
+            window.load1.add(sample.cpu_load_avg_1min);
+            window.load5.add(sample.cpu_load_avg_5min);
+            window.load15.add(sample.cpu_load_avg_15min);
+            window.usage.add(sample.cpu_usage);
+            window.frequency.add(sample.cpu_frequency);
+            for (std::size_t core = 0; core < cores; ++core) {
+                window.perCore[core].add(sample.per_core_usage[core]);
+            }
+        }
+    }
+
+    // Outside the lock, the bus calls straight into the server
+    for (const auto& rollup : closed) {
+        eventBus_.publish(rollup);
+    }
+}
+
+void RollupAggregator::Accumulator::add(double x) {
+    if (count == 0) {
+        min = x;
+        max = x;
+    } else {
+        min = std::min(min, x);
+        max = std::max(max, x);
+    }
+    sum += x;
+    ++count;
+    p95.add(x);
+}
+
+message::RollupStats RollupAggregator::Accumulator::stats() const {
+    if (count == 0)
+        return {};
+    return {min, max, sum / static_cast<double>(count), p95.value()};
+}
+
+void RollupAggregator::Window::reset(int64_t start, std::size_t cores) {
+    startMs = start;
+    samples = 0;
+    load1 = {};
+    load5 = {};
+    load15 = {};
+    usage = {};
+    frequency = {};
+    perCore.assign(cores, {});
+}
+
+message::CpuRollup RollupAggregator::Window::close() const {
+    message::CpuRollup rollup;
+    rollup.window_s = static_cast<int>(length.count());
+    rollup.start = startMs;
+    rollup.samples = samples;
+    rollup.cpu_load_avg_1min = load1.stats();
+    rollup.cpu_load_avg_5min = load5.stats();
+    rollup.cpu_load_avg_15min = load15.stats();
+    rollup.cpu_usage = usage.stats();
+    rollup.cpu_frequency = frequency.stats();
+
+    rollup.per_core_usage.reserve(perCore.size());
+    for (const Accumulator& core : perCore) {
+        rollup.per_core_usage.push_back(core.stats());
+    }
+    return rollup;
+}
@@ -0,0 +1,57 @@
+#ifndef ROLLUP_H
+#define ROLLUP_H
+
+#include <chrono>
+#include <event_bus.h>
+#include <json.hpp>
+#include <mutex>
+#include <vector>
+#include "p2_quantile.h"
+
+// Aggregates CpuInfo into fixed, wall-clock aligned windows and publishes a CPU_ROLLUP
+// for every window that closes, so clients plotting long ranges can take one message
+// per window instead of every raw sample. O(1) per sample and metric.
+class RollupAggregator {
+public:
+    RollupAggregator(EventBus& eventBus,
+                     std::vector<std::chrono::seconds> windows = {
+                         std::chrono::seconds(10), std::chrono::minutes(1),
+                         std::chrono::minutes(5)});
+
+    void add(int64_t timestampMs, const message::CpuInfo& sample);
+
+private:
+    // Running min/max/mean/p95 of one metric
+    struct Accumulator {
+        double min = 0;
+        double max = 0;
+        double sum = 0;
+        std::size_t count = 0;
+        P2Quantile p95{0.95};
+
+        void add(double x);
+        message::RollupStats stats() const;
+    };
+
+    struct Window {
+        std::chrono::seconds length;
+        int64_t startMs = -1;
+        int samples = 0;
+        Accumulator load1;
+        Accumulator load5;
+        Accumulator load15;
+        Accumulator usage;
+        Accumulator frequency;
+        std::vector<Accumulator> perCore;
+
+        void reset(int64_t start, std::size_t cores);
+        message::CpuRollup close() const;
+    };
+
+    EventBus& eventBus_;
+
+    std::mutex mutex_;
+    std::vector<Window> windows_;
+};
+
+#endif  // ROLLUP_H
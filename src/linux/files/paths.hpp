@@ -5,6 +5,7 @@
 #include <unistd.h>
 #include <filesystem>
 #include <string>
+#include <string_view>
 
 namespace paths {
     inline std::string getExecutablePath() {
@@ -13,6 +14,21 @@ namespace paths {
         return exe.parent_path().string();
     }
 
+    // Prefix for every /proc and /sys path the modules read, empty for the live system.
+    // Benchmarks point it at a fixture tree, modules pick it up when constructed.
+    inline std::string& hostRoot() {
+        static std::string root;
+        return root;
+    }
+
+    inline void setHostRoot(std::string root) {
+        hostRoot() = std::move(root);
+    }
+
+    inline std::string hostPath(std::string_view path) {
+        return hostRoot() + std::string(path);
+    }
+
     inline const char* libDir() {
         static std::string path;
         if (path.empty()) {
@@ -31,6 +47,16 @@ namespace paths {
         return path.c_str();
     }
 
+    inline const char* ticketKeysFile() {
+        static std::string path = std::string(libDir()) + "/ticket_keys.bin";
+        return path.c_str();
+    }
+
+    inline const char* journalDir() {
+        static std::string path = std::string(libDir()) + "/journal";
+        return path.c_str();
+    }
+
     inline const char* pidFile() {
         static std::string path = std::string(libDir()) + "/nodewatcher.pid";
         return path.c_str();
@@ -0,0 +1,81 @@
+#include <fcntl.h>
+#include <proc_file.h>
+#include <unistd.h>
+#include <cerrno>
+#include <utility>
+
+ProcFile::ProcFile(std::string path, std::size_t initialCapacity)
+    : path_(std::move(path)), buffer_(initialCapacity) {
+    open();
+}
+
+ProcFile::~ProcFile() {
+    close();
+}
+
+ProcFile::ProcFile(ProcFile&& other) noexcept
+    : path_(std::move(other.path_)),
+      fd_(std::exchange(other.fd_, -1)),
+      buffer_(std::move(other.buffer_)) {}
+
+ProcFile& ProcFile::operator=(ProcFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        path_ = std::move(other.path_);
+        fd_ = std::exchange(other.fd_, -1);
+        buffer_ = std::move(other.buffer_);
+    }
+    return *this;
+}
+
+bool ProcFile::open() {
+    close();
+    fd_ = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    return fd_ >= 0;
+}
+
+void ProcFile::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+std::string_view ProcFile::read() {
+    std::size_t size = 0;
+
+    // A failed read usually means the file went away (e.g. CPU hotplug), so reopen
+    // once before giving up.
+    if (!readAll(size) && (!open() || !readAll(size)))
+        return {};
+
+    return std::string_view(buffer_.data(), size);
+}
+
+bool ProcFile::readAll(std::size_t& size) {
+    if (fd_ < 0)
+        return false;
+
+    if (buffer_.empty())
+        buffer_.resize(4096);
+
+    size = 0;
+    while (true) {
+        std::size_t want = buffer_.size() - size;
+        ssize_t n = ::pread(fd_, buffer_.data() + size, want, static_cast<off_t>(size));
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+
+        size += static_cast<std::size_t>(n);
+
+        // procfs and sysfs fill the whole buffer unless they hit EOF, so a short read
+        // means we are done and the common case costs a single pread().
+        if (static_cast<std::size_t>(n) < want)
+            return true;
+
+        buffer_.resize(buffer_.size() * 2);
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef PROC_FILE_H
+#define PROC_FILE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Keeps a /proc or /sys file open and re-reads it from offset 0 with pread() into a
+// reusable buffer, so periodic sampling costs one syscall instead of open/read/close.
+class ProcFile {
+public:
+    ProcFile() = default;
+    explicit ProcFile(std::string path, std::size_t initialCapacity = 4096);
+    ~ProcFile();
+
+    ProcFile(const ProcFile&) = delete;
+    ProcFile& operator=(const ProcFile&) = delete;
+    ProcFile(ProcFile&& other) noexcept;
+    ProcFile& operator=(ProcFile&& other) noexcept;
+
+    bool open();
+    void close();
+    bool isOpen() const { return fd_ >= 0; }
+    const std::string& path() const { return path_; }
+
+    // Returns the current file contents, or an empty view if the file cannot be read.
+    // The view stays valid until the next call to read().
+    std::string_view read();
+
+private:
+    bool readAll(std::size_t& size);
+
+    std::string path_;
+    int fd_ = -1;
+    std::vector<char> buffer_;
+};
+
+#endif  // PROC_FILE_H
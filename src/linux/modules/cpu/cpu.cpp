@@ -1,10 +1,47 @@
 #include <cpu.h>
 #include <sys/utsname.h>
+#include <unistd.h>
+#include <charconv>
 #include <fstream>
 #include <json.hpp>
 #include <set>
 #include <vector>
 
+namespace {
+    // Kernel CPU list, e.g. "0-7,16-23\n"
+    std::vector<int> parseCpuList(std::string_view list) {
+        std::vector<int> cpus;
+        const char* p = list.data();
+        const char* end = p + list.size();
+
+        while (p < end) {
+            int first = 0;
+            auto [next, ec] = std::from_chars(p, end, first);
+            if (ec != std::errc())
+                break;
+
+            int last = first;
+            if (next < end && *next == '-') {
+                auto [after, rangeEc] = std::from_chars(next + 1, end, last);
+                if (rangeEc != std::errc())
+                    break;
+                next = after;
+            }
+
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+
+            p = next;
+            if (p == end || *p != ',')
+                break;
+            ++p;
+        }
+
+        return cpus;
+    }
+}  // namespace
+
 CPUInfo::CPUInfo(EventBus& eventBus, std::chrono::milliseconds period)
     : eventBus_(eventBus), period_(period) {
     getCPUModel();
@@ -12,6 +49,7 @@ CPUInfo::CPUInfo(EventBus& eventBus, std::chrono::milliseconds period)
     getCPUMaxFrequency();
     getCPUCores();
     getCPUThreads();
+    openFrequencyFiles();
 }
 
 message::MessageVariantOUT CPUInfo::getStaticData() {
@@ -21,6 +59,14 @@ message::MessageVariantOUT CPUInfo::getStaticData() {
 }
 
 void CPUInfo::collect() {
+    // CPU hotplug changes the set of cpufreq files, so pick up the new layout. The mask
+    // is compared rather than a count, offlining one CPU and onlining another keeps it.
+    if (has_online_ && cpu_online_.read() != online_mask_)
+        openFrequencyFiles();
+
+    // Read and parse /proc/stat once per tick, both usage helpers use the same snapshot
+    readCpuTimes();
+
     double load1, load5, load15;
     getCPULoadAvg(load1, load5, load15);
     message::CpuInfo cpu_info(load1, load5, load15, getCpuUsage(), getPerCoreUsage(),
@@ -32,8 +78,12 @@ std::chrono::milliseconds CPUInfo::period() {
     return period_;
 }
 
+std::string_view CPUInfo::name() {
+    return "cpu";
+}
+
 void CPUInfo::getCPUModel() {
-    std::ifstream file("/proc/cpuinfo");
+    std::ifstream file(paths::hostPath("/proc/cpuinfo"));
     std::string line;
 
     cpu_model_ = "Unknown";
@@ -54,7 +104,8 @@ void CPUInfo::getCPUArchitecture() {
 }
 
 void CPUInfo::getCPUMaxFrequency() {
-    std::ifstream file("/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq");
+    std::ifstream file(
+        paths::hostPath("/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq"));
     int freq = 0;
 
     if (!(file >> freq) || freq <= 0) {
@@ -66,7 +117,7 @@ void CPUInfo::getCPUMaxFrequency() {
 }
 
 void CPUInfo::getCPUCores() {
-    std::ifstream file("/proc/cpuinfo");
+    std::ifstream file(paths::hostPath("/proc/cpuinfo"));
     std::set<std::string> cores;
 
     std::string line;
@@ -96,16 +147,27 @@ void CPUInfo::getCPUCores() {
 }
 
 void CPUInfo::getCPUThreads() {
-    cpu_threads_ = sysconf(_SC_NPROCESSORS_ONLN);
+    cpu_threads_ = static_cast<int>(onlineCpus().size());
 }
 
 void CPUInfo::getCPULoadAvg(double& load1, double& load5, double& load15) {
+    // "0.52 0.58 0.59 1/467 12345", the same file getloadavg() opens on every call
+    std::string_view data = loadavg_.read();
+    const char* p = data.data();
+    const char* end = p + data.size();
+
     double load[3];
-    if (getloadavg(load, 3) != 3) {
-        load1 = 0.0;
-        load5 = 0.0;
-        load15 = 0.0;
-        return;
+    for (double& value : load) {
+        while (p < end && *p == ' ')
+            ++p;
+        auto [next, ec] = std::from_chars(p, end, value);
+        if (ec != std::errc()) {
+            load1 = 0.0;
+            load5 = 0.0;
+            load15 = 0.0;
+            return;
+        }
+        p = next;
     }
 
     load1 = load[0];
@@ -115,34 +177,33 @@ void CPUInfo::getCPULoadAvg(double& load1, double& load5, double& load15) {
 
 double CPUInfo::getCpuUsage() {
     if (!cpu_initialized_) {
-        previous_total_times_ = readCpuTimes();
+        previous_total_times_ = current_total_times_;
         cpu_initialized_ = true;
         return 0.0;
     }
 
-    CpuTimes current_total_times = readCpuTimes();
-    double usage = calcCpuUsage(previous_total_times_, current_total_times);
-    previous_total_times_ = current_total_times;
+    double usage = calcCpuUsage(previous_total_times_, current_total_times_);
+    previous_total_times_ = current_total_times_;
     return usage;
 }
 
 std::vector<double> CPUInfo::getPerCoreUsage() {
-    if (!per_core_initialized_) {
-        int cpu_count = cpu_cores_ > 0 ? cpu_cores_ : sysconf(_SC_NPROCESSORS_ONLN);
-        previous_per_core_times_.resize(cpu_count);
-        for (int i = 0; i < cpu_count; ++i) {
-            previous_per_core_times_[i] = readCpuTimes(i);
-        }
+    std::size_t cpu_count = current_per_core_times_.size();
+
+    // Start over when a CPU was hot-added or removed, deltas would be meaningless
+    if (!per_core_initialized_ || previous_per_core_times_.size() != cpu_count) {
+        previous_per_core_times_ = current_per_core_times_;
         per_core_initialized_ = true;
         return std::vector<double>(cpu_count, 0.0);
     }
-    int cpu_count = previous_per_core_times_.size();
+
     std::vector<double> usages(cpu_count);
-    for (int i = 0; i < cpu_count; ++i) {
-        CpuTimes current_times = readCpuTimes(i);
-        usages[i] = calcCpuUsage(previous_per_core_times_[i], current_times);
-        previous_per_core_times_[i] = current_times;
+    for (std::size_t i = 0; i < cpu_count; ++i) {
+        usages[i] = calcCpuUsage(previous_per_core_times_[i], current_per_core_times_[i]);
     }
+
+    // Swap instead of copy so both buffers keep their capacity
+    std::swap(previous_per_core_times_, current_per_core_times_);
     return usages;
 }
 
@@ -150,15 +211,13 @@ int CPUInfo::getCPUFrequency() {
     long long sum = 0;
     int count = 0;
 
-    for (int cpu = 0;; ++cpu) {
-        std::ifstream f("/sys/devices/system/cpu/cpu" + std::to_string(cpu) +
-                        "/cpufreq/scaling_cur_freq");
-
-        if (!f.is_open())
-            break;
+    for (auto& file : freq_files_) {
+        std::string_view data = file.read();
+        if (data.empty())
+            continue;
 
         long khz = 0;
-        f >> khz;
+        std::from_chars(data.data(), data.data() + data.size(), khz);
 
         if (khz > 0) {
             sum += khz;
@@ -172,22 +231,40 @@ int CPUInfo::getCPUFrequency() {
     return static_cast<int>(sum / count);
 }
 
-CpuTimes CPUInfo::readCpuTimes(int core) {
-    std::ifstream f("/proc/stat");
-    std::string line;
+void CPUInfo::openFrequencyFiles() {
+    if (has_online_)
+        online_mask_ = cpu_online_.read();
+
+    freq_files_.clear();
+    for (int cpu : onlineCpus()) {
+        std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) +
+                           "/cpufreq/scaling_cur_freq";
+        ProcFile file(paths::hostPath(path), 64);
+
+        // Not every machine exposes cpufreq, VMs often don't
+        if (file.isOpen())
+            freq_files_.push_back(std::move(file));
+    }
+}
+
+std::vector<int> CPUInfo::onlineCpus() {
+    std::vector<int> cpus;
+    if (has_online_)
+        cpus = parseCpuList(cpu_online_.read());
 
-    while (std::getline(f, line)) {
-        if ((core == -1 && line.starts_with("cpu ")) ||
-            (core >= 0 && line.starts_with("cpu" + std::to_string(core)))) {
-            CpuTimes t{};
-            std::stringstream ss(line);
-            std::string cpu;
-            ss >> cpu >> t.user >> t.nice >> t.system >> t.idle >> t.iowait >> t.irq >>
-                t.softirq >> t.steal;
-            return t;
+    // No sysfs mounted, as in some containers: assume ids 0..n-1
+    if (cpus.empty()) {
+        const long online = sysconf(_SC_NPROCESSORS_ONLN);
+        for (long cpu = 0; cpu < online; ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
         }
     }
-    return {};
+
+    return cpus;
+}
+
+void CPUInfo::readCpuTimes() {
+    procstat::parse(proc_stat_.read(), current_total_times_, current_per_core_times_);
 }
 
 double CPUInfo::calcCpuUsage(const CpuTimes& a, const CpuTimes& b) {
@@ -197,5 +274,9 @@ double CPUInfo::calcCpuUsage(const CpuTimes& a, const CpuTimes& b) {
     long long totalA = idleA + a.user + a.nice + a.system + a.irq + a.softirq + a.steal;
     long long totalB = idleB + b.user + b.nice + b.system + b.irq + b.softirq + b.steal;
 
+    // No ticks elapsed (or an offline CPU that stopped reporting)
+    if (totalB - totalA <= 0)
+        return 0.0;
+
     return 100.0 * (1.0 - (double)(idleB - idleA) / (totalB - totalA));
 }
\ No newline at end of file
@@ -3,19 +3,19 @@
 
 #include <event_bus.h>
 #include <light_module.h>
+#include <paths.hpp>
+#include <proc_file.h>
+#include <proc_stat.h>
 #include <static_resource.h>
 #include <string>
 
-struct CpuTimes {
-    long long user, nice, system, idle, iowait, irq, softirq, steal;
-};
-
 class CPUInfo : public IStaticResource, public ILightModule {
 public:
     CPUInfo(EventBus& eventBus, std::chrono::milliseconds period);
     message::MessageVariantOUT getStaticData() override;
     void collect() override;
     std::chrono::milliseconds period() override;
+    std::string_view name() override;
 
 private:
     // Static system information retrieval methods
@@ -32,7 +32,9 @@ private:
     int getCPUFrequency();
 
     // Helpers
-    CpuTimes readCpuTimes(int core = -1);
+    void openFrequencyFiles();
+    std::vector<int> onlineCpus();
+    void readCpuTimes();
     double calcCpuUsage(const CpuTimes& a, const CpuTimes& b);
 
     EventBus& eventBus_;
@@ -46,7 +48,21 @@ private:
     bool cpu_initialized_ = false;
     bool per_core_initialized_ = false;
     CpuTimes previous_total_times_;
+    CpuTimes current_total_times_;
     std::vector<CpuTimes> previous_per_core_times_;
+    std::vector<CpuTimes> current_per_core_times_;
+
+    // Persistent handles, re-read with pread() on every tick
+    ProcFile proc_stat_{paths::hostPath("/proc/stat")};
+    ProcFile loadavg_{paths::hostPath("/proc/loadavg"), 128};
+    std::vector<ProcFile> freq_files_;
+    // e.g. "0-7,16-23". sysconf(_SC_NPROCESSORS_ONLN) would open and parse it per call,
+    // and always on the real host rather than under paths::hostPath().
+    ProcFile cpu_online_{paths::hostPath("/sys/devices/system/cpu/online"), 64};
+    // Without sysfs read() would retry the open() every tick, a handle that failed to
+    // open at construction is never read
+    bool has_online_ = cpu_online_.isOpen();
+    std::string online_mask_;
 };
 
 #endif  // CPU_H
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include <proc_stat.h>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace procstat {
+    namespace {
+        void skipSpaces(const char*& p, const char* end) {
+            while (p < end && *p == ' ')
+                ++p;
+        }
+
+        long long parseField(const char*& p, const char* end) {
+            skipSpaces(p, end);
+            long long value = 0;
+            auto [next, ec] = std::from_chars(p, end, value);
+            p = next;
+            return ec == std::errc() ? value : 0;
+        }
+
+        void parseTimes(const char*& p, const char* end, CpuTimes& t) {
+            t.user = parseField(p, end);
+            t.nice = parseField(p, end);
+            t.system = parseField(p, end);
+            t.idle = parseField(p, end);
+            t.iowait = parseField(p, end);
+            t.irq = parseField(p, end);
+            t.softirq = parseField(p, end);
+            t.steal = parseField(p, end);
+        }
+    }  // namespace
+
+    bool parse(std::string_view data, CpuTimes& total, std::vector<CpuTimes>& perCore) {
+        const char* p = data.data();
+        const char* end = p + data.size();
+
+        bool haveTotal = false;
+        std::size_t cores = 0;
+
+        while (p < end) {
+            const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (eol == nullptr)
+                eol = end;
+
+            // All cpu lines come first, stop before the (long) intr/softirq lines
+            if (eol - p < 4 || p[0] != 'c' || p[1] != 'p' || p[2] != 'u')
+                break;
+
+            const char* q = p + 3;
+            if (*q == ' ') {
+                parseTimes(q, eol, total);
+                haveTotal = true;
+            } else {
+                // Parse the full index so that cpu1 and cpu10 never get confused
+                std::size_t index = 0;
+                auto [next, ec] = std::from_chars(q, eol, index);
+                if (ec == std::errc() && next < eol && *next == ' ') {
+                    if (index >= perCore.size())
+                        perCore.resize(index + 1);
+
+                    parseTimes(next, eol, perCore[index]);
+                    cores = std::max(cores, index + 1);
+                }
+            }
+
+            p = eol + 1;
+        }
+
+        // CPUs at the top of the range went offline
+        if (cores < perCore.size())
+            perCore.resize(cores);
+
+        return haveTotal;
+    }
+}  // namespace procstat
@@ -0,0 +1,18 @@
+#ifndef PROC_STAT_H
+#define PROC_STAT_H
+
+#include <string_view>
+#include <vector>
+
+struct CpuTimes {
+    long long user, nice, system, idle, iowait, irq, softirq, steal;
+};
+
+namespace procstat {
+    // Parses the "cpu" and "cpuN" lines of a /proc/stat snapshot in a single pass.
+    // perCore is indexed by CPU number; it only reallocates when a higher CPU number
+    // than before shows up. Returns false if the aggregate line is missing.
+    bool parse(std::string_view data, CpuTimes& total, std::vector<CpuTimes>& perCore);
+}  // namespace procstat
+
+#endif  // PROC_STAT_H
@@ -0,0 +1,195 @@
+#include <disk.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <json.hpp>
+
+namespace {
+    unsigned long long delta(unsigned long long a, unsigned long long b) {
+        // 32-bit kernels wrap the counters, skip that tick rather than report a spike
+        return b >= a ? b - a : 0;
+    }
+
+    bool isLoopDevice(std::string_view device) {
+        return device.starts_with("loop") || device.starts_with("ram");
+    }
+
+    std::string activeScheduler(const std::filesystem::path& file) {
+        // "mq-deadline kyber [bfq] none", the active one is in brackets
+        std::ifstream in(file);
+        std::string line;
+        std::getline(in, line);
+
+        auto open = line.find('[');
+        auto close = line.find(']', open);
+        if (open == std::string::npos || close == std::string::npos)
+            return "none";
+        return line.substr(open + 1, close - open - 1);
+    }
+}  // namespace
+
+DiskInfo::DiskInfo(EventBus& eventBus,
+                   std::chrono::milliseconds period,
+                   DiskInfoOptions options)
+    : eventBus_(eventBus), period_(period), options_(options) {
+    readInventory();
+}
+
+message::MessageVariantOUT DiskInfo::getStaticData() {
+    message::DiskInfoStatic disk_info_static;
+    {
+        std::lock_guard lk(inventory_mutex_);
+        disk_info_static.devices = inventory_;
+    }
+    return disk_info_static;
+}
+
+void DiskInfo::collect() {
+    auto now = std::chrono::steady_clock::now();
+    procdiskstats::parse(diskstats_.read(), samples_);
+
+    // Device names only change on hot-add/remove, every other tick is a straight walk
+    if (layoutChanged())
+        reindex();
+
+    double seconds = std::chrono::duration<double>(now - previous_sample_).count();
+    previous_sample_ = now;
+
+    message::DiskInfo disk_info;
+    disk_info.devices.reserve(reported_count_);
+
+    for (std::size_t i = 0; i < samples_.size(); ++i) {
+        DeviceState& state = devices_[i];
+        const DiskCounters& current = samples_[i].counters;
+
+        if (state.reported) {
+            if (state.primed)
+                disk_info.devices.push_back(
+                    calcRates(state.name, state.previous, current, seconds));
+            else
+                disk_info.devices.push_back({.name = state.name});
+        }
+
+        state.previous = current;
+        state.primed = true;
+    }
+
+    eventBus_.publish(disk_info);
+}
+
+std::chrono::milliseconds DiskInfo::period() {
+    return period_;
+}
+
+std::string_view DiskInfo::name() {
+    return "disk";
+}
+
+void DiskInfo::readInventory() {
+    std::vector<message::DiskDevice> inventory;
+
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(sys_block_, ec)) {
+        std::string name = entry.path().filename().string();
+        if (!options_.loopDevices && isLoopDevice(name))
+            continue;
+
+        message::DiskDevice device;
+        device.name = name;
+
+        int rotational = 0;
+        std::ifstream(entry.path() / "queue/rotational") >> rotational;
+        device.rotational = rotational != 0;
+
+        // Always in 512-byte sectors
+        long long sectors = 0;
+        std::ifstream(entry.path() / "size") >> sectors;
+        device.size = sectors * 512;
+
+        device.scheduler = activeScheduler(entry.path() / "queue/scheduler");
+        inventory.push_back(std::move(device));
+    }
+
+    std::sort(inventory.begin(), inventory.end(),
+              [](const auto& a, const auto& b) { return a.name < b.name; });
+
+    std::lock_guard lk(inventory_mutex_);
+    inventory_ = std::move(inventory);
+}
+
+bool DiskInfo::layoutChanged() const {
+    if (samples_.size() != devices_.size())
+        return true;
+
+    for (std::size_t i = 0; i < samples_.size(); ++i) {
+        if (samples_[i].name != devices_[i].name)
+            return true;
+    }
+    return false;
+}
+
+void DiskInfo::reindex() {
+    // A device appeared or went away, so /sys/block changed as well
+    readInventory();
+
+    std::vector<DeviceState> devices(samples_.size());
+    reported_count_ = 0;
+
+    for (std::size_t i = 0; i < samples_.size(); ++i) {
+        std::string_view device = samples_[i].name;
+
+        // Keep the previous counters of devices that are still there
+        auto it = std::find_if(devices_.begin(), devices_.end(),
+                               [&](const DeviceState& s) { return s.name == device; });
+        if (it != devices_.end())
+            devices[i] = std::move(*it);
+        else
+            devices[i].name = std::string(device);
+
+        devices[i].reported = isReported(device);
+        reported_count_ += devices[i].reported;
+    }
+
+    devices_ = std::move(devices);
+}
+
+bool DiskInfo::isReported(std::string_view device) const {
+    if (!options_.loopDevices && isLoopDevice(device))
+        return false;
+
+    // Only whole disks have a /sys/block entry. Called on the collector thread, the only
+    // one that writes inventory_.
+    bool disk = std::any_of(inventory_.begin(), inventory_.end(),
+                            [&](const auto& d) { return d.name == device; });
+    return disk || options_.partitions;
+}
+
+message::DiskStat DiskInfo::calcRates(const std::string& device,
+                                      const DiskCounters& a,
+                                      const DiskCounters& b,
+                                      double seconds) {
+    message::DiskStat stat;
+    stat.name = device;
+
+    // No time elapsed, e.g. two ticks within the clock resolution
+    if (seconds <= 0.0)
+        return stat;
+
+    unsigned long long reads = delta(a.reads, b.reads);
+    unsigned long long writes = delta(a.writes, b.writes);
+    double ms = seconds * 1000.0;
+
+    stat.read_iops = reads / seconds;
+    stat.write_iops = writes / seconds;
+    stat.read_bytes = delta(a.read_sectors, b.read_sectors) * 512.0 / seconds;
+    stat.write_bytes = delta(a.write_sectors, b.write_sectors) * 512.0 / seconds;
+    stat.queue_depth = delta(a.weighted_ms, b.weighted_ms) / ms;
+    stat.utilization = std::min(100.0, 100.0 * delta(a.io_ms, b.io_ms) / ms);
+
+    if (reads + writes > 0)
+        stat.await = static_cast<double>(delta(a.read_ms, b.read_ms) +
+                                         delta(a.write_ms, b.write_ms)) /
+                     (reads + writes);
+
+    return stat;
+}
@@ -0,0 +1,73 @@
+#ifndef DISK_H
+#define DISK_H
+
+#include <event_bus.h>
+#include <light_module.h>
+#include <paths.hpp>
+#include <proc_diskstats.h>
+#include <proc_file.h>
+#include <static_resource.h>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct DiskInfoOptions {
+    // Partitions are listed next to their disk and repeat its traffic
+    bool partitions = false;
+    // loop and ram block devices, often dozens of idle ones from snaps and containers
+    bool loopDevices = false;
+};
+
+class DiskInfo : public IStaticResource, public ILightModule {
+public:
+    DiskInfo(EventBus& eventBus,
+             std::chrono::milliseconds period,
+             DiskInfoOptions options = {});
+    message::MessageVariantOUT getStaticData() override;
+    void collect() override;
+    std::chrono::milliseconds period() override;
+    std::string_view name() override;
+
+private:
+    // State of one /proc/diskstats line, devices_ follows the file order
+    struct DeviceState {
+        std::string name;
+        bool reported = false;
+        bool primed = false;
+        DiskCounters previous{};
+    };
+
+    // Static device information retrieval methods
+    void readInventory();
+
+    // Helpers
+    bool layoutChanged() const;
+    void reindex();
+    bool isReported(std::string_view device) const;
+    message::DiskStat calcRates(const std::string& device,
+                                const DiskCounters& a,
+                                const DiskCounters& b,
+                                double seconds);
+
+    EventBus& eventBus_;
+    std::chrono::milliseconds period_;
+    DiskInfoOptions options_;
+
+    // Rebuilt on the collector thread when devices come and go, read by the server
+    // threads through getStaticData()
+    std::mutex inventory_mutex_;
+    std::vector<message::DiskDevice> inventory_;
+
+    // Re-scanned whenever the diskstats layout changes
+    std::string sys_block_ = paths::hostPath("/sys/block");
+
+    // Persistent handle, re-read with pread() on every tick
+    ProcFile diskstats_{paths::hostPath("/proc/diskstats"), 8192};
+    std::vector<DiskSample> samples_;
+    std::vector<DeviceState> devices_;
+    std::size_t reported_count_ = 0;
+    std::chrono::steady_clock::time_point previous_sample_;
+};
+
+#endif  // DISK_H
@@ -0,0 +1,65 @@
+#include <proc_diskstats.h>
+#include <charconv>
+#include <cstring>
+
+namespace procdiskstats {
+    namespace {
+        void skipSpaces(const char*& p, const char* end) {
+            while (p < end && *p == ' ')
+                ++p;
+        }
+
+        unsigned long long parseField(const char*& p, const char* end) {
+            skipSpaces(p, end);
+            unsigned long long value = 0;
+            auto [next, ec] = std::from_chars(p, end, value);
+            p = next;
+            return ec == std::errc() ? value : 0;
+        }
+    }  // namespace
+
+    void parse(std::string_view data, std::vector<DiskSample>& out) {
+        out.clear();
+
+        const char* p = data.data();
+        const char* end = p + data.size();
+
+        while (p < end) {
+            const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (eol == nullptr)
+                eol = end;
+
+            // "   8       0 sda 1234 56 ..." major and minor first, then the name
+            const char* q = p;
+            parseField(q, eol);
+            parseField(q, eol);
+            skipSpaces(q, eol);
+
+            const char* nameEnd = q;
+            while (nameEnd < eol && *nameEnd != ' ')
+                ++nameEnd;
+
+            if (nameEnd > q) {
+                DiskSample& sample = out.emplace_back();
+                sample.name = std::string_view(q, nameEnd - q);
+
+                DiskCounters& c = sample.counters;
+                q = nameEnd;
+                c.reads = parseField(q, eol);
+                parseField(q, eol);  // reads merged
+                c.read_sectors = parseField(q, eol);
+                c.read_ms = parseField(q, eol);
+                c.writes = parseField(q, eol);
+                parseField(q, eol);  // writes merged
+                c.write_sectors = parseField(q, eol);
+                c.write_ms = parseField(q, eol);
+                c.in_flight = parseField(q, eol);
+                c.io_ms = parseField(q, eol);
+                c.weighted_ms = parseField(q, eol);
+                // Discard and flush fields (4.18+, 5.5+) follow, we don't report them
+            }
+
+            p = eol + 1;
+        }
+    }
+}  // namespace procdiskstats
@@ -0,0 +1,27 @@
+#ifndef PROC_DISKSTATS_H
+#define PROC_DISKSTATS_H
+
+#include <string_view>
+#include <vector>
+
+// Cumulative counters of one /proc/diskstats line. Sectors are 512 bytes regardless
+// of the device's block size, times are milliseconds.
+struct DiskCounters {
+    unsigned long long reads, read_sectors, read_ms;
+    unsigned long long writes, write_sectors, write_ms;
+    unsigned long long in_flight, io_ms, weighted_ms;
+};
+
+struct DiskSample {
+    std::string_view name;
+    DiskCounters counters;
+};
+
+namespace procdiskstats {
+    // Parses every line of a /proc/diskstats snapshot into out, in file order. Names
+    // point into data. out is cleared first and keeps its capacity, so steady-state
+    // parsing does not allocate.
+    void parse(std::string_view data, std::vector<DiskSample>& out);
+}  // namespace procdiskstats
+
+#endif  // PROC_DISKSTATS_H
@@ -0,0 +1,23 @@
+#include <heavy_module.h>
+#include <time.h>
+
+namespace {
+    int64_t threadCpuNs() {
+        timespec ts{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return ts.tv_sec * 1'000'000'000LL + ts.tv_nsec;
+    }
+}  // namespace
+
+HeavyContext::HeavyContext(std::stop_token st, std::chrono::nanoseconds cpuBudget)
+    : st_(std::move(st)), started_ns_(threadCpuNs()), budget_ns_(cpuBudget.count()) {}
+
+bool HeavyContext::shouldYield() const {
+    return st_.stop_requested() || threadCpuNs() - started_ns_ > budget_ns_;
+}
+
+std::chrono::nanoseconds HeavyContext::cpuUsed() const {
+    return std::chrono::nanoseconds(threadCpuNs() - started_ns_);
+}
+
+IHeavyModule::~IHeavyModule() = default;
\ No newline at end of file
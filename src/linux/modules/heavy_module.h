@@ -0,0 +1,48 @@
+#ifndef HEAVY_MODULE_H
+#define HEAVY_MODULE_H
+
+#include <chrono>
+#include <cstdint>
+#include <stop_token>
+#include <string_view>
+
+// Handed to every IHeavyModule pass: the executor's stop request and the thread CPU
+// time the module may spend before it has to give the core back
+class HeavyContext {
+public:
+    HeavyContext(std::stop_token st, std::chrono::nanoseconds cpuBudget);
+
+    const std::stop_token& stopToken() const { return st_; }
+
+    // True once a stop was requested or the pass has used up its CPU budget. Reads
+    // CLOCK_THREAD_CPUTIME_ID, which is a real syscall, so call it every few dozen
+    // units of work rather than after each one.
+    bool shouldYield() const;
+
+    // Thread CPU time spent since the pass started
+    std::chrono::nanoseconds cpuUsed() const;
+
+private:
+    std::stop_token st_;
+    int64_t started_ns_;
+    int64_t budget_ns_;
+};
+
+// Expensive collector (process scans, filesystem walks, SMART reads) run by
+// HeavyExecutor on a low-priority thread instead of the Scheduler's pool
+class IHeavyModule {
+public:
+    virtual ~IHeavyModule();
+
+    // One pass. Long passes check ctx.shouldYield() between units of work, return
+    // early when it says so and continue where they stopped on the next pass.
+    virtual void collect(HeavyContext& ctx) = 0;
+
+    // Pause between the end of one pass and the start of the next
+    virtual std::chrono::milliseconds period() = 0;
+
+    // Short identifier for self-metrics, e.g. "process"
+    virtual std::string_view name() = 0;
+};
+
+#endif  // HEAVY_MODULE_H
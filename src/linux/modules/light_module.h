@@ -2,6 +2,7 @@
 #define LIGHT_MODULE_H
 
 #include <chrono>
+#include <string_view>
 
 class ILightModule {
 public:
@@ -10,6 +11,9 @@ public:
     virtual void collect() = 0;
 
     virtual std::chrono::milliseconds period() = 0;
+
+    // Short identifier for self-metrics, e.g. "cpu"
+    virtual std::string_view name() = 0;
 };
 
 #endif  // LIGHT_MODULE_H
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include <mem.h>
+#include <json.hpp>
+
+MemInfo::MemInfo(EventBus& eventBus, std::chrono::milliseconds period)
+    : eventBus_(eventBus), period_(period) {
+    procmem::parseMeminfo(meminfo_.read(), counters_);
+    mem_total_ = counters_.mem_total;
+    swap_total_ = counters_.swap_total;
+    has_pressure_ = pressure_file_.isOpen();
+}
+
+message::MessageVariantOUT MemInfo::getStaticData() {
+    message::MemInfoStatic mem_info_static(mem_total_, swap_total_);
+    return mem_info_static;
+}
+
+void MemInfo::collect() {
+    procmem::parseMeminfo(meminfo_.read(), counters_);
+    procmem::parseVmstat(vmstat_.read(), vm_counters_);
+    if (has_pressure_)
+        procmem::parsePressure(pressure_file_.read(), pressure_);
+
+    message::MemInfo mem_info;
+    mem_info.mem_available = getAvailable();
+    mem_info.mem_used = counters_.mem_total - mem_info.mem_available;
+    mem_info.mem_usage =
+        counters_.mem_total > 0 ? 100.0 * mem_info.mem_used / counters_.mem_total : 0.0;
+
+    // SwapTotal follows swapon/swapoff, so usage is against the current value
+    mem_info.swap_used = counters_.swap_total - counters_.swap_free;
+    mem_info.swap_usage = counters_.swap_total > 0
+                              ? 100.0 * mem_info.swap_used / counters_.swap_total
+                              : 0.0;
+
+    mem_info.cached = counters_.cached;
+    mem_info.dirty = counters_.dirty;
+    mem_info.writeback = counters_.writeback;
+    mem_info.major_faults = getMajorFaultRate();
+
+    mem_info.pressure_some_avg10 = pressure_.some_avg10;
+    mem_info.pressure_some_avg60 = pressure_.some_avg60;
+    mem_info.pressure_full_avg10 = pressure_.full_avg10;
+    mem_info.pressure_full_avg60 = pressure_.full_avg60;
+
+    eventBus_.publish(mem_info);
+}
+
+std::chrono::milliseconds MemInfo::period() {
+    return period_;
+}
+
+std::string_view MemInfo::name() {
+    return "memory";
+}
+
+int64_t MemInfo::getAvailable() {
+    // MemAvailable appeared in 3.14, estimate it the way free(1) did before
+    if (counters_.mem_available > 0)
+        return counters_.mem_available;
+    return counters_.mem_free + counters_.buffers + counters_.cached;
+}
+
+double MemInfo::getMajorFaultRate() {
+    auto now = std::chrono::steady_clock::now();
+    long long faults = vm_counters_.pgmajfault;
+
+    if (!faults_initialized_) {
+        previous_major_faults_ = faults;
+        previous_sample_ = now;
+        faults_initialized_ = true;
+        return 0.0;
+    }
+
+    double seconds = std::chrono::duration<double>(now - previous_sample_).count();
+    long long delta = faults - previous_major_faults_;
+    previous_major_faults_ = faults;
+    previous_sample_ = now;
+
+    // Counter went backwards (container restart) or no time passed
+    if (seconds <= 0.0 || delta < 0)
+        return 0.0;
+
+    return delta / seconds;
+}
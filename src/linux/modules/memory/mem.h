@@ -0,0 +1,48 @@
+#ifndef MEM_H
+#define MEM_H
+
+#include <event_bus.h>
+#include <light_module.h>
+#include <paths.hpp>
+#include <proc_file.h>
+#include <proc_meminfo.h>
+#include <static_resource.h>
+#include <chrono>
+
+class MemInfo : public IStaticResource, public ILightModule {
+public:
+    MemInfo(EventBus& eventBus, std::chrono::milliseconds period);
+    message::MessageVariantOUT getStaticData() override;
+    void collect() override;
+    std::chrono::milliseconds period() override;
+    std::string_view name() override;
+
+private:
+    // Dynamic memory information retrieval methods
+    int64_t getAvailable();
+    double getMajorFaultRate();
+
+    EventBus& eventBus_;
+    std::chrono::milliseconds period_;
+
+    int64_t mem_total_ = 0;
+    int64_t swap_total_ = 0;
+
+    MemCounters counters_{};
+    VmCounters vm_counters_{};
+    MemPressure pressure_{};
+
+    bool faults_initialized_ = false;
+    long long previous_major_faults_ = 0;
+    std::chrono::steady_clock::time_point previous_sample_;
+
+    // Persistent handles, re-read with pread() on every tick
+    ProcFile meminfo_{paths::hostPath("/proc/meminfo")};
+    ProcFile vmstat_{paths::hostPath("/proc/vmstat"), 8192};
+    ProcFile pressure_file_{paths::hostPath("/proc/pressure/memory"), 256};
+    // Kernels without PSI have no /proc/pressure. read() would retry the open() every
+    // tick, so a handle that failed to open at startup is never read.
+    bool has_pressure_ = false;
+};
+
+#endif  // MEM_H
@@ -0,0 +1,120 @@
+#include <proc_meminfo.h>
+#include <charconv>
+#include <cstring>
+
+namespace procmem {
+    namespace {
+        template <typename T>
+        struct Field {
+            std::string_view key;
+            long long T::* member;
+        };
+
+        constexpr Field<MemCounters> kMeminfoFields[] = {
+            {"MemTotal", &MemCounters::mem_total},
+            {"MemFree", &MemCounters::mem_free},
+            {"MemAvailable", &MemCounters::mem_available},
+            {"Buffers", &MemCounters::buffers},
+            {"Cached", &MemCounters::cached},
+            {"SwapTotal", &MemCounters::swap_total},
+            {"SwapFree", &MemCounters::swap_free},
+            {"Dirty", &MemCounters::dirty},
+            {"Writeback", &MemCounters::writeback},
+        };
+
+        constexpr Field<VmCounters> kVmstatFields[] = {
+            {"pgmajfault", &VmCounters::pgmajfault},
+        };
+
+        // "Key:   value kB" in /proc/meminfo, "key value" in /proc/vmstat
+        template <typename T, std::size_t N>
+        bool parseTable(std::string_view data,
+                        const Field<T> (&table)[N],
+                        char separator,
+                        T& out) {
+            out = T{};
+
+            const char* p = data.data();
+            const char* end = p + data.size();
+            std::size_t found = 0;
+
+            while (p < end && found < N) {
+                const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+                if (eol == nullptr)
+                    eol = end;
+
+                const char* sep =
+                    static_cast<const char*>(std::memchr(p, separator, eol - p));
+                if (sep != nullptr) {
+                    std::string_view key(p, sep - p);
+                    for (const auto& field : table) {
+                        if (field.key != key)
+                            continue;
+
+                        const char* q = sep + 1;
+                        while (q < eol && *q == ' ')
+                            ++q;
+                        std::from_chars(q, eol, out.*field.member);
+                        ++found;
+                        break;
+                    }
+                }
+
+                p = eol + 1;
+            }
+
+            return found > 0;
+        }
+
+        // Value of "name=" in [p, end), 0 if it is missing
+        double pressureValue(const char* p, const char* end, std::string_view name) {
+            std::string_view line(p, end - p);
+            std::size_t pos = line.find(name);
+            if (pos == std::string_view::npos)
+                return 0.0;
+
+            double value = 0.0;
+            std::from_chars(p + pos + name.size(), end, value);
+            return value;
+        }
+    }  // namespace
+
+    bool parseMeminfo(std::string_view data, MemCounters& out) {
+        return parseTable(data, kMeminfoFields, ':', out);
+    }
+
+    bool parseVmstat(std::string_view data, VmCounters& out) {
+        return parseTable(data, kVmstatFields, ' ', out);
+    }
+
+    bool parsePressure(std::string_view data, MemPressure& out) {
+        out = MemPressure{};
+
+        // some avg10=0.00 avg60=0.00 avg300=0.00 total=0
+        // full avg10=0.00 avg60=0.00 avg300=0.00 total=0
+        const char* p = data.data();
+        const char* end = p + data.size();
+        bool found = false;
+
+        while (p < end) {
+            const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (eol == nullptr)
+                eol = end;
+
+            std::string_view line(p, eol - p);
+            if (line.starts_with("some ")) {
+                out.some_avg10 = pressureValue(p, eol, "avg10=");
+                out.some_avg60 = pressureValue(p, eol, "avg60=");
+                found = true;
+            } else if (line.starts_with("full ")) {
+                out.full_avg10 = pressureValue(p, eol, "avg10=");
+                out.full_avg60 = pressureValue(p, eol, "avg60=");
+                found = true;
+            }
+
+            p = eol + 1;
+        }
+
+        return found;
+    }
+}  // namespace procmem
@@ -0,0 +1,31 @@
+#ifndef PROC_MEMINFO_H
+#define PROC_MEMINFO_H
+
+#include <string_view>
+
+// /proc/meminfo values in kB
+struct MemCounters {
+    long long mem_total, mem_free, mem_available, buffers, cached, swap_total, swap_free,
+        dirty, writeback;
+};
+
+// Cumulative /proc/vmstat event counters
+struct VmCounters {
+    long long pgmajfault;
+};
+
+// /proc/pressure/memory stall percentages
+struct MemPressure {
+    double some_avg10, some_avg60, full_avg10, full_avg60;
+};
+
+namespace procmem {
+    // Each parser looks its keys up in a fixed table while walking the snapshot once,
+    // and stops as soon as every key has been seen. Keys missing from the file are left
+    // at 0. Return false if none of them were found.
+    bool parseMeminfo(std::string_view data, MemCounters& out);
+    bool parseVmstat(std::string_view data, VmCounters& out);
+    bool parsePressure(std::string_view data, MemPressure& out);
+}  // namespace procmem
+
+#endif  // PROC_MEMINFO_H
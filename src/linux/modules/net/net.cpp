@@ -0,0 +1,145 @@
+#include <fnmatch.h>
+#include <net.h>
+#include <algorithm>
+#include <json.hpp>
+
+namespace {
+    unsigned long long delta(unsigned long long a, unsigned long long b) {
+        // Counters restart when a driver resets the device
+        return b >= a ? b - a : 0;
+    }
+
+    bool matchesAny(const std::vector<std::string>& globs, const std::string& name) {
+        return std::any_of(globs.begin(), globs.end(), [&](const std::string& glob) {
+            return fnmatch(glob.c_str(), name.c_str(), 0) == 0;
+        });
+    }
+
+    void addTo(message::NetStat& total, const message::NetStat& stat) {
+        total.rx_bytes += stat.rx_bytes;
+        total.tx_bytes += stat.tx_bytes;
+        total.rx_packets += stat.rx_packets;
+        total.tx_packets += stat.tx_packets;
+        total.rx_errors += stat.rx_errors;
+        total.tx_errors += stat.tx_errors;
+        total.rx_dropped += stat.rx_dropped;
+        total.tx_dropped += stat.tx_dropped;
+    }
+}  // namespace
+
+NetInfo::NetInfo(EventBus& eventBus,
+                 std::chrono::milliseconds period,
+                 NetInfoOptions options)
+    : eventBus_(eventBus), period_(period), options_(std::move(options)) {}
+
+void NetInfo::collect() {
+    auto now = std::chrono::steady_clock::now();
+    if (!link_dump_.dump(samples_))
+        return;
+
+    // Interfaces only change when containers start or stop, every other tick is a
+    // straight walk without glob matching
+    if (layoutChanged())
+        reindex();
+
+    double seconds = std::chrono::duration<double>(now - previous_sample_).count();
+    previous_sample_ = now;
+
+    message::NetInfo net_info;
+    net_info.interfaces.reserve(reported_count_);
+    net_info.total.name = "total";
+
+    for (std::size_t i = 0; i < samples_.size(); ++i) {
+        InterfaceState& state = interfaces_[i];
+        const rtnl_link_stats64& current = samples_[i].stats;
+
+        if (state.reported) {
+            if (state.primed) {
+                net_info.interfaces.push_back(
+                    calcRates(state.name, state.previous, current, seconds));
+                addTo(net_info.total, net_info.interfaces.back());
+            } else {
+                net_info.interfaces.push_back({.name = state.name});
+            }
+        }
+
+        state.previous = current;
+        state.primed = true;
+    }
+
+    eventBus_.publish(net_info);
+}
+
+std::chrono::milliseconds NetInfo::period() {
+    return period_;
+}
+
+std::string_view NetInfo::name() {
+    return "net";
+}
+
+bool NetInfo::layoutChanged() const {
+    if (samples_.size() != interfaces_.size())
+        return true;
+
+    // Indexes are never reused while the old interface exists, a rename keeps the
+    // index, so compare both
+    for (std::size_t i = 0; i < samples_.size(); ++i) {
+        if (samples_[i].index != interfaces_[i].index ||
+            samples_[i].nameView() != interfaces_[i].name)
+            return true;
+    }
+    return false;
+}
+
+void NetInfo::reindex() {
+    std::vector<InterfaceState> interfaces(samples_.size());
+    reported_count_ = 0;
+
+    for (std::size_t i = 0; i < samples_.size(); ++i) {
+        const LinkSample& sample = samples_[i];
+
+        // Keep the previous counters of interfaces that are still there
+        auto it = std::find_if(
+            interfaces_.begin(), interfaces_.end(),
+            [&](const InterfaceState& s) { return s.index == sample.index; });
+        if (it != interfaces_.end())
+            interfaces[i] = std::move(*it);
+
+        interfaces[i].index = sample.index;
+        interfaces[i].name = sample.name;
+        interfaces[i].reported = isReported(interfaces[i].name);
+        reported_count_ += interfaces[i].reported;
+    }
+
+    interfaces_ = std::move(interfaces);
+}
+
+bool NetInfo::isReported(std::string_view interface) const {
+    std::string name(interface);
+    if (matchesAny(options_.exclude, name))
+        return false;
+    return options_.include.empty() || matchesAny(options_.include, name);
+}
+
+message::NetStat NetInfo::calcRates(const std::string& interface,
+                                    const rtnl_link_stats64& a,
+                                    const rtnl_link_stats64& b,
+                                    double seconds) {
+    message::NetStat stat;
+    stat.name = interface;
+
+    // No time elapsed, e.g. two ticks within the clock resolution
+    if (seconds <= 0.0)
+        return stat;
+
+    stat.rx_bytes = delta(a.rx_bytes, b.rx_bytes) / seconds;
+    stat.tx_bytes = delta(a.tx_bytes, b.tx_bytes) / seconds;
+    stat.rx_packets = delta(a.rx_packets, b.rx_packets) / seconds;
+    stat.tx_packets = delta(a.tx_packets, b.tx_packets) / seconds;
+    stat.rx_errors = delta(a.rx_errors, b.rx_errors) / seconds;
+    stat.tx_errors = delta(a.tx_errors, b.tx_errors) / seconds;
+    stat.rx_dropped = delta(a.rx_dropped, b.rx_dropped) / seconds;
+    stat.tx_dropped = delta(a.tx_dropped, b.tx_dropped) / seconds;
+    return stat;
+}
@@ -0,0 +1,57 @@
+#ifndef NET_H
+#define NET_H
+
+#include <event_bus.h>
+#include <light_module.h>
+#include <rtnl_link.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+struct NetInfoOptions {
+    // fnmatch() globs on the interface name. An empty include list reports every
+    // interface, exclude wins over include.
+    std::vector<std::string> include;
+    std::vector<std::string> exclude;
+};
+
+class NetInfo : public ILightModule {
+public:
+    NetInfo(EventBus& eventBus,
+            std::chrono::milliseconds period,
+            NetInfoOptions options = {});
+    void collect() override;
+    std::chrono::milliseconds period() override;
+    std::string_view name() override;
+
+private:
+    // State of one interface, interfaces_ follows the order of the dump
+    struct InterfaceState {
+        int index = 0;
+        std::string name;
+        bool reported = false;
+        bool primed = false;
+        rtnl_link_stats64 previous{};
+    };
+
+    // Helpers
+    bool layoutChanged() const;
+    void reindex();
+    bool isReported(std::string_view interface) const;
+    message::NetStat calcRates(const std::string& interface,
+                               const rtnl_link_stats64& a,
+                               const rtnl_link_stats64& b,
+                               double seconds);
+
+    EventBus& eventBus_;
+    std::chrono::milliseconds period_;
+    NetInfoOptions options_;
+
+    LinkDump link_dump_;
+    std::vector<LinkSample> samples_;
+    std::vector<InterfaceState> interfaces_;
+    std::size_t reported_count_ = 0;
+    std::chrono::steady_clock::time_point previous_sample_;
+};
+
+#endif  // NET_H
@@ -0,0 +1,133 @@
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <rtnl_link.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace rtnl {
+    namespace {
+        void parseLink(const nlmsghdr* nh, std::vector<LinkSample>& out) {
+            if (nh->nlmsg_len < NLMSG_LENGTH(sizeof(ifinfomsg)))
+                return;
+
+            const auto* ifi = static_cast<const ifinfomsg*>(NLMSG_DATA(nh));
+            int length =
+                static_cast<int>(nh->nlmsg_len - NLMSG_LENGTH(sizeof(ifinfomsg)));
+
+            LinkSample& sample = out.emplace_back();
+            sample.index = ifi->ifi_index;
+            sample.name[0] = '\0';
+            sample.stats = {};
+
+            for (const rtattr* rta = IFLA_RTA(ifi); RTA_OK(rta, length);
+                 rta = RTA_NEXT(rta, length)) {
+                const std::size_t size = RTA_PAYLOAD(rta);
+
+                if (rta->rta_type == IFLA_IFNAME) {
+                    std::size_t n = std::min(size, sizeof(sample.name) - 1);
+                    std::memcpy(sample.name, RTA_DATA(rta), n);
+                    sample.name[n] = '\0';
+                } else if (rta->rta_type == IFLA_STATS64) {
+                    // Older kernels send a shorter struct, the rest stays zero
+                    std::memcpy(&sample.stats, RTA_DATA(rta),
+                                std::min(size, sizeof(sample.stats)));
+                }
+            }
+        }
+    }  // namespace
+
+    ParseResult parseLinks(const char* data,
+                           std::size_t size,
+                           uint32_t seq,
+                           std::vector<LinkSample>& out) {
+        int length = static_cast<int>(size);
+
+        for (auto* nh = reinterpret_cast<const nlmsghdr*>(data); NLMSG_OK(nh, length);
+             nh = NLMSG_NEXT(nh, length)) {
+            if (nh->nlmsg_seq != seq)
+                continue;
+
+            if (nh->nlmsg_type == NLMSG_DONE)
+                return ParseResult::DONE;
+            if (nh->nlmsg_type == NLMSG_ERROR)
+                return ParseResult::ERROR;
+            if (nh->nlmsg_type == RTM_NEWLINK)
+                parseLink(nh, out);
+        }
+
+        return ParseResult::MORE;
+    }
+}  // namespace rtnl
+
+LinkDump::LinkDump() : buffer_(64 * 1024) {
+    open();
+}
+
+LinkDump::~LinkDump() {
+    close();
+}
+
+bool LinkDump::open() {
+    close();
+    fd_ = ::socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (fd_ < 0)
+        return false;
+
+    // The kernel always answers a dump, this only guards against a wedged socket
+    timeval timeout{.tv_sec = 1, .tv_usec = 0};
+    setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return true;
+}
+
+void LinkDump::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool LinkDump::dump(std::vector<LinkSample>& out) {
+    out.clear();
+    if (fd_ < 0 && !open())
+        return false;
+
+    struct {
+        nlmsghdr nh;
+        ifinfomsg ifi;
+    } request{};
+    request.nh.nlmsg_len = sizeof(request);
+    request.nh.nlmsg_type = RTM_GETLINK;
+    request.nh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    request.nh.nlmsg_seq = ++seq_;
+    request.ifi.ifi_family = AF_UNSPEC;
+
+    if (::send(fd_, &request, sizeof(request), 0) < 0) {
+        // Reopen next tick rather than keep using a broken socket
+        close();
+        return false;
+    }
+
+    while (true) {
+        ssize_t n = ::recv(fd_, buffer_.data(), buffer_.size(), 0);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            close();
+            return false;
+        }
+
+        auto result =
+            rtnl::parseLinks(buffer_.data(), static_cast<std::size_t>(n), seq_, out);
+        switch (result) {
+            case rtnl::ParseResult::DONE:
+                return true;
+            case rtnl::ParseResult::ERROR:
+                return false;
+            case rtnl::ParseResult::MORE:
+                break;
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef RTNL_LINK_H
+#define RTNL_LINK_H
+
+#include <linux/if_link.h>
+#include <net/if.h>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+struct LinkSample {
+    int index;
+    char name[IFNAMSIZ];
+    rtnl_link_stats64 stats;
+
+    std::string_view nameView() const { return name; }
+};
+
+namespace rtnl {
+    enum class ParseResult { MORE, DONE, ERROR };
+
+    // Appends the RTM_NEWLINK entries of one recv() of a link dump with sequence number
+    // seq to out. Messages of other requests are skipped.
+    ParseResult parseLinks(const char* data,
+                           std::size_t size,
+                           uint32_t seq,
+                           std::vector<LinkSample>& out);
+}  // namespace rtnl
+
+// Keeps a NETLINK_ROUTE socket open and fetches the name and rtnl_link_stats64 of every
+// interface with one RTM_GETLINK dump, instead of formatting and parsing the text of
+// /proc/net/dev.
+class LinkDump {
+public:
+    LinkDump();
+    ~LinkDump();
+
+    LinkDump(const LinkDump&) = delete;
+    LinkDump& operator=(const LinkDump&) = delete;
+
+    bool isOpen() const { return fd_ >= 0; }
+
+    // Replaces out with the current interfaces in kernel order. out keeps its capacity,
+    // so steady-state dumps do not allocate. Returns false if the dump failed.
+    bool dump(std::vector<LinkSample>& out);
+
+private:
+    bool open();
+    void close();
+
+    int fd_ = -1;
+    uint32_t seq_ = 0;
+    std::vector<char> buffer_;
+};
+
+#endif  // RTNL_LINK_H
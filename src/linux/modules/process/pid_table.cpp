@@ -0,0 +1,61 @@
+#include <pid_table.h>
+#include <algorithm>
+#include <bit>
+
+namespace {
+    // splitmix64 finalizer, consecutive pids land far apart
+    uint64_t mix(uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+}  // namespace
+
+PidTable::PidTable(std::size_t capacity)
+    : slots_(std::bit_ceil(std::max<std::size_t>(capacity, 16))) {}
+
+const PidTable::Entry* PidTable::find(int pid, unsigned long long starttime) const {
+    const Entry& entry = slots_[slotFor(pid, starttime)];
+    return entry.pid != 0 ? &entry : nullptr;
+}
+
+void PidTable::insert(const Entry& entry) {
+    // Keep the load factor at or below 1/2 so probe sequences stay short
+    if (2 * (size_ + 1) > slots_.size())
+        grow();
+
+    slots_[slotFor(entry.pid, entry.starttime)] = entry;
+    ++size_;
+}
+
+void PidTable::clear() {
+    std::fill(slots_.begin(), slots_.end(), Entry{});
+    size_ = 0;
+}
+
+std::size_t PidTable::slotFor(int pid, unsigned long long starttime) const {
+    const std::size_t mask = slots_.size() - 1;
+    std::size_t slot = mix(static_cast<uint64_t>(pid) << 32 ^ starttime) & mask;
+
+    // Stops at the entry itself or the first free slot, where it would go
+    while (slots_[slot].pid != 0 &&
+           (slots_[slot].pid != pid || slots_[slot].starttime != starttime)) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void PidTable::grow() {
+    std::vector<Entry> old(slots_.size() * 2);
+    old.swap(slots_);
+    size_ = 0;
+
+    for (const Entry& entry : old) {
+        if (entry.pid != 0) {
+            slots_[slotFor(entry.pid, entry.starttime)] = entry;
+            ++size_;
+        }
+    }
+}
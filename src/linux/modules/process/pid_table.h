@@ -0,0 +1,40 @@
+#ifndef PID_TABLE_H
+#define PID_TABLE_H
+
+#include <cstdint>
+#include <vector>
+
+// Open-addressing hash map with linear probing from (pid, starttime) to the CPU time a
+// process had at its last sample. The start time tells a reused pid apart from the
+// process that had it before. There is no erase, the process table builds a fresh
+// table every scan and swaps it with the previous one.
+class PidTable {
+public:
+    struct Entry {
+        int pid = 0;  // 0 marks a free slot, the kernel never lists pid 0
+        unsigned long long starttime = 0;
+        unsigned long long cpu_ticks = 0;
+        int64_t sampled_ns = 0;
+    };
+
+    explicit PidTable(std::size_t capacity = 1024);
+
+    const Entry* find(int pid, unsigned long long starttime) const;
+
+    // Each key is inserted at most once per table
+    void insert(const Entry& entry);
+
+    // Empties the table but keeps its capacity
+    void clear();
+
+    std::size_t size() const { return size_; }
+
+private:
+    std::size_t slotFor(int pid, unsigned long long starttime) const;
+    void grow();
+
+    std::vector<Entry> slots_;
+    std::size_t size_ = 0;
+};
+
+#endif  // PID_TABLE_H
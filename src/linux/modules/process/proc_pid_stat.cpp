@@ -0,0 +1,65 @@
+#include <proc_pid_stat.h>
+#include <utf8.hpp>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace procpid {
+    namespace {
+        void skipFields(const char*& p, const char* end, int count) {
+            for (int i = 0; i < count; ++i) {
+                while (p < end && *p == ' ')
+                    ++p;
+                while (p < end && *p != ' ')
+                    ++p;
+            }
+        }
+
+        template <typename T>
+        bool parseField(const char*& p, const char* end, T& value) {
+            while (p < end && *p == ' ')
+                ++p;
+            auto [next, ec] = std::from_chars(p, end, value);
+            p = next;
+            return ec == std::errc();
+        }
+    }  // namespace
+
+    bool parseStat(std::string_view data, PidStat& out) {
+        // "1234 (comm) S 1 1234 ..." field numbers below follow proc(5)
+        const char* begin = data.data();
+        const char* end = begin + data.size();
+
+        const char* open = static_cast<const char*>(std::memchr(begin, '(', data.size()));
+        const char* close = static_cast<const char*>(memrchr(begin, ')', data.size()));
+        if (open == nullptr || close == nullptr || close < open || end - close < 3)
+            return false;
+
+        std::size_t length =
+            std::min<std::size_t>(close - open - 1, sizeof(out.comm) - 1);
+        std::memcpy(out.comm, open + 1, length);
+        out.comm[length] = '\0';
+
+        const char* p = close + 2;
+        out.state = *p++;
+
+        skipFields(p, end, 10);  // 4 ppid .. 13 cmajflt
+        if (!parseField(p, end, out.utime) || !parseField(p, end, out.stime))
+            return false;
+
+        skipFields(p, end, 4);  // 16 cutime .. 19 nice
+        if (!parseField(p, end, out.threads))
+            return false;
+
+        skipFields(p, end, 1);  // 21 itrealvalue
+        if (!parseField(p, end, out.starttime))
+            return false;
+
+        skipFields(p, end, 1);  // 23 vsize
+        return parseField(p, end, out.rss);
+    }
+
+    std::string sanitizeComm(std::string_view comm) {
+        return message::utf8::sanitize(comm);
+    }
+}  // namespace procpid
@@ -0,0 +1,28 @@
+#ifndef PROC_PID_STAT_H
+#define PROC_PID_STAT_H
+
+#include <string>
+#include <string_view>
+
+// The fields of /proc/[pid]/stat the process table uses. Times are in clock ticks,
+// rss in pages.
+struct PidStat {
+    char comm[16];
+    char state;
+    unsigned long long utime, stime, starttime;
+    long long rss;
+    long threads;
+};
+
+namespace procpid {
+    // Parses one /proc/[pid]/stat line. comm may contain spaces and parentheses, so the
+    // fields are located from the last ')'. Returns false on a truncated line.
+    bool parseStat(std::string_view data, PidStat& out);
+
+    // comm is whatever bytes the process set, cut at 15 by the kernel, possibly in the
+    // middle of a UTF-8 sequence. Returns it as valid UTF-8, every invalid or truncated
+    // sequence replaced by one U+FFFD.
+    std::string sanitizeComm(std::string_view comm);
+}  // namespace procpid
+
+#endif  // PROC_PID_STAT_H
@@ -0,0 +1,178 @@
+#include <dirent.h>
+#include <fcntl.h>
+#include <proc_pid_stat.h>
+#include <process.h>
+#include <unistd.h>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <json.hpp>
+
+namespace {
+    int64_t steadyNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    // shouldYield() costs a syscall, so only ask every this many processes
+    constexpr std::size_t kBudgetCheckInterval = 64;
+}  // namespace
+
+ProcessTable::ProcessTable(EventBus& eventBus,
+                           std::chrono::milliseconds period,
+                           ProcessTableOptions options)
+    : eventBus_(eventBus),
+      period_(period),
+      options_(options),
+      clock_ticks_(sysconf(_SC_CLK_TCK)),
+      page_kb_(sysconf(_SC_PAGESIZE) / 1024),
+      dirents_(32 * 1024) {
+    proc_fd_ = open(paths::hostPath("/proc").c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+}
+
+ProcessTable::~ProcessTable() {
+    if (proc_fd_ >= 0)
+        close(proc_fd_);
+}
+
+void ProcessTable::collect(HeavyContext& ctx) {
+    if (proc_fd_ < 0)
+        return;
+
+    slice_ns_ = steadyNs();
+    if (!scanning_)
+        beginScan();
+
+    std::size_t sampled = 0;
+
+    while (cursor_ < pids_.size()) {
+        // Out of time: keep the cursor and pick the scan up on the next call
+        if (++sampled % kBudgetCheckInterval == 0 && ctx.shouldYield())
+            return;
+
+        sampleProcess(pids_[cursor_++]);
+    }
+
+    finishScan();
+}
+
+std::chrono::milliseconds ProcessTable::period() {
+    return period_;
+}
+
+std::string_view ProcessTable::name() {
+    return "process";
+}
+
+void ProcessTable::beginScan() {
+    listPids();
+    cursor_ = 0;
+    rows_.clear();
+    current_.clear();
+
+    // Processes seen for the first time are measured over their whole lifetime
+    std::string_view data = uptime_.read();
+    double seconds = 0.0;
+    std::from_chars(data.data(), data.data() + data.size(), seconds);
+    uptime_ticks_ = seconds * clock_ticks_;
+
+    scanning_ = true;
+}
+
+void ProcessTable::listPids() {
+    pids_.clear();
+    lseek(proc_fd_, 0, SEEK_SET);
+
+    while (true) {
+        ssize_t n = getdents64(proc_fd_, dirents_.data(), dirents_.size());
+        if (n <= 0)
+            break;
+
+        for (ssize_t offset = 0; offset < n;) {
+            const auto* entry =
+                reinterpret_cast<const dirent64*>(dirents_.data() + offset);
+            offset += entry->d_reclen;
+
+            // Everything that isn't a pid starts with a letter
+            const char* name = entry->d_name;
+            if (*name < '0' || *name > '9')
+                continue;
+
+            int pid = 0;
+            std::from_chars(name, name + std::strlen(name), pid);
+            if (pid > 0)
+                pids_.push_back(pid);
+        }
+    }
+}
+
+void ProcessTable::sampleProcess(int pid) {
+    char path[24];
+    char* end = std::to_chars(path, path + 16, pid).ptr;
+    std::memcpy(end, "/stat", 6);
+
+    // Exited since listPids()
+    int fd = openat(proc_fd_, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+    ssize_t n = read(fd, stat_buffer_, sizeof(stat_buffer_));
+    close(fd);
+
+    PidStat stat;
+    if (n <= 0 || !procpid::parseStat(std::string_view(stat_buffer_, n), stat))
+        return;
+
+    const unsigned long long ticks = stat.utime + stat.stime;
+    double usage = 0.0;
+
+    if (const PidTable::Entry* prev = previous_.find(pid, stat.starttime)) {
+        double seconds = (slice_ns_ - prev->sampled_ns) / 1e9;
+        if (seconds > 0.0 && ticks >= prev->cpu_ticks)
+            usage = 100.0 * (ticks - prev->cpu_ticks) / clock_ticks_ / seconds;
+    } else if (uptime_ticks_ > stat.starttime) {
+        usage = 100.0 * ticks / (uptime_ticks_ - stat.starttime);
+    }
+
+    current_.insert({pid, stat.starttime, ticks, slice_ns_});
+
+    Row& row = rows_.emplace_back();
+    row.pid = pid;
+    std::memcpy(row.comm, stat.comm, sizeof(row.comm));
+    row.cpu_usage = usage;
+    row.rss = stat.rss * page_kb_;
+    row.threads = stat.threads;
+}
+
+void ProcessTable::finishScan() {
+    scanning_ = false;
+
+    // Processes that exited are simply not carried over
+    std::swap(previous_, current_);
+
+    message::ProcessInfo info;
+    info.processes = static_cast<int>(rows_.size());
+    info.top_cpu =
+        top([](const Row& a, const Row& b) { return a.cpu_usage > b.cpu_usage; });
+    info.top_memory = top([](const Row& a, const Row& b) { return a.rss > b.rss; });
+
+    eventBus_.publish(info);
+}
+
+template <typename Compare>
+std::vector<message::ProcessStat> ProcessTable::top(Compare compare) {
+    // Only the first topN rows need to be in order
+    const std::size_t n = std::min(options_.topN, rows_.size());
+    std::partial_sort(rows_.begin(), rows_.begin() + n, rows_.end(), compare);
+
+    std::vector<message::ProcessStat> result;
+    result.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const Row& row = rows_[i];
+        // Only the rows that go out pay for the UTF-8 check. JsonWriter would replace
+        // bad bytes too, this keeps MessagePack and CBOR clients on the same names.
+        result.push_back({row.pid, procpid::sanitizeComm(row.comm), row.cpu_usage,
+                          row.rss, static_cast<int>(row.threads)});
+    }
+    return result;
+}
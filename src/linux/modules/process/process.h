@@ -0,0 +1,78 @@
+#ifndef PROCESS_H
+#define PROCESS_H
+
+#include <event_bus.h>
+#include <heavy_module.h>
+#include <paths.hpp>
+#include <pid_table.h>
+#include <proc_file.h>
+#include <chrono>
+#include <vector>
+
+struct ProcessTableOptions {
+    // Entries in each of the top lists
+    std::size_t topN = 10;
+};
+
+// Scans /proc/[pid]/stat and publishes the top processes by CPU and memory. Previous
+// CPU times are kept per (pid, starttime), so every scan only computes deltas. A scan
+// that runs out of CPU budget continues on the next pass, so huge hosts get a complete
+// table every few periods instead of a collector that hogs a core.
+class ProcessTable : public IHeavyModule {
+public:
+    ProcessTable(EventBus& eventBus,
+                 std::chrono::milliseconds period,
+                 ProcessTableOptions options = {});
+    ~ProcessTable();
+
+    ProcessTable(const ProcessTable&) = delete;
+    ProcessTable& operator=(const ProcessTable&) = delete;
+
+    void collect(HeavyContext& ctx) override;
+    std::chrono::milliseconds period() override;
+    std::string_view name() override;
+
+private:
+    struct Row {
+        int pid;
+        char comm[16];
+        double cpu_usage;
+        long long rss;
+        long threads;
+    };
+
+    // Helpers
+    void beginScan();
+    void listPids();
+    void sampleProcess(int pid);
+    void finishScan();
+    template <typename Compare>
+    std::vector<message::ProcessStat> top(Compare compare);
+
+    EventBus& eventBus_;
+    std::chrono::milliseconds period_;
+    ProcessTableOptions options_;
+
+    // /proc stays open, every stat file is opened relative to it
+    int proc_fd_ = -1;
+    ProcFile uptime_{paths::hostPath("/proc/uptime"), 64};
+    long clock_ticks_;
+    long page_kb_;
+
+    // The scan in progress, possibly spread over several collect() calls
+    bool scanning_ = false;
+    std::vector<int> pids_;
+    std::size_t cursor_ = 0;
+    double uptime_ticks_ = 0;
+    int64_t slice_ns_ = 0;
+    std::vector<Row> rows_;
+
+    // Samples of the last complete scan, and of the one in progress
+    PidTable previous_;
+    PidTable current_;
+
+    std::vector<char> dirents_;
+    char stat_buffer_[1024];
+};
+
+#endif  // PROCESS_H
@@ -0,0 +1,125 @@
+#include <heavy_executor.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+HeavyExecutor::HeavyExecutor(HeavyExecutorOptions options)
+    : options_(std::move(options)) {}
+
+HeavyExecutor::~HeavyExecutor() {
+    stop();
+}
+
+void HeavyExecutor::add(IHeavyModule* m, std::chrono::milliseconds cpuBudget) {
+    const std::string prefix = "collect." + std::string(m->name());
+
+    std::lock_guard lk(mutex_);
+    modules_.push_back({m, cpuBudget, &metrics::histogram(prefix + "_ns"),
+                        &metrics::histogram(prefix + "_cpu_ns"),
+                        &metrics::counter(prefix + "_over_budget")});
+
+    if (running_)
+        launch(modules_.back());
+}
+
+void HeavyExecutor::start() {
+    std::lock_guard lk(mutex_);
+    if (running_)
+        return;
+
+    running_ = true;
+    for (auto& state : modules_) {
+        launch(state);
+    }
+}
+
+void HeavyExecutor::stop() {
+    std::vector<std::jthread> threads;
+    {
+        std::lock_guard lk(mutex_);
+        if (!running_)
+            return;
+        running_ = false;
+        threads = std::move(threads_);
+        threads_.clear();
+    }
+
+    // Wakes the waits below through their stop tokens, then joins. Outside the lock,
+    // which the threads take to wait.
+    threads.clear();
+}
+
+void HeavyExecutor::setIdle(bool idle) {
+    {
+        std::lock_guard lk(mutex_);
+        idle_ = idle;
+    }
+    cv_.notify_all();
+}
+
+void HeavyExecutor::launch(ModuleState& state) {
+    threads_.emplace_back([this, &state](std::stop_token st) {
+        lowerPriority();
+        run(state, st);
+    });
+}
+
+void HeavyExecutor::lowerPriority() {
+    // Both are best effort: a container without CAP_SYS_NICE may refuse them, and the
+    // module still works at normal priority
+    if (options_.idlePriority) {
+        sched_param param{};
+        if (pthread_setschedparam(pthread_self(), SCHED_IDLE, &param) != 0)
+            setpriority(PRIO_PROCESS, gettid(), 19);
+    }
+
+    if (!options_.cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : options_.cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE)
+                CPU_SET(cpu, &set);
+        }
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+}
+
+void HeavyExecutor::run(ModuleState& state, std::stop_token st) {
+    Clock::time_point next = Clock::now();
+
+    while (!st.stop_requested()) {
+        {
+            std::unique_lock lk(mutex_);
+            cv_.wait_until(lk, st, next, [] { return false; });
+            cv_.wait(lk, st, [&] { return !idle_; });
+        }
+
+        if (st.stop_requested())
+            return;
+
+        HeavyContext ctx(st, state.cpuBudget);
+        {
+            metrics::ScopedTimer timer(*state.collectTime);
+            state.module->collect(ctx);
+        }
+
+        const auto used = ctx.cpuUsed();
+        state.cpuTime->record(used.count());
+
+        // Fixed delay rather than the Scheduler's fixed rate: a pass that overran its
+        // period is followed by a full pause instead of running back to back
+        auto pause = std::chrono::duration_cast<Clock::duration>(state.module->period());
+
+        // A pass that ignored shouldYield(), or whose last unit of work was large, pays
+        // for the excess with a proportionally longer pause
+        if (used > state.cpuBudget && state.cpuBudget.count() > 0) {
+            state.overBudget->add();
+            const double excess = std::chrono::duration<double>(used - state.cpuBudget) /
+                                  state.cpuBudget;
+            pause += std::chrono::duration_cast<Clock::duration>(pause * excess);
+        }
+
+        next = Clock::now() + pause;
+    }
+}
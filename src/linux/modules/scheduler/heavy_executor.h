@@ -0,0 +1,68 @@
+#ifndef HEAVY_EXECUTOR_H
+#define HEAVY_EXECUTOR_H
+
+#include <heavy_module.h>
+#include <metrics.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+struct HeavyExecutorOptions {
+    // Run under SCHED_IDLE, or nice 19 where that is refused, so the threads only get
+    // cores nothing else wants
+    bool idlePriority = true;
+    // CPUs the threads may run on, e.g. the housekeeping cores. Empty leaves the
+    // inherited affinity alone.
+    std::vector<int> cpus;
+};
+
+// Runs every IHeavyModule on a low-priority thread of its own, so a pass that takes
+// hundreds of milliseconds never holds up the light collectors or another heavy module
+class HeavyExecutor {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit HeavyExecutor(HeavyExecutorOptions options = {});
+    ~HeavyExecutor();
+
+    // cpuBudget is the thread CPU time one pass may use. A module that overshoots it
+    // gets a longer pause afterwards, keeping its share at cpuBudget / period.
+    void add(IHeavyModule* m, std::chrono::milliseconds cpuBudget);
+
+    void start();
+    void stop();
+
+    // While idle (nobody is listening) no new passes start
+    void setIdle(bool idle);
+
+private:
+    struct ModuleState {
+        IHeavyModule* module;
+        std::chrono::milliseconds cpuBudget;
+        metrics::Histogram* collectTime = nullptr;
+        metrics::Histogram* cpuTime = nullptr;
+        metrics::Counter* overBudget = nullptr;
+    };
+
+    void run(ModuleState& state, std::stop_token st);
+    void launch(ModuleState& state);
+    void lowerPriority();
+
+    HeavyExecutorOptions options_;
+
+    // deque keeps references stable for the threads while add() appends
+    std::deque<ModuleState> modules_;
+
+    std::mutex mutex_;
+    std::condition_variable_any cv_;
+    bool running_ = false;
+    bool idle_ = false;
+
+    std::vector<std::jthread> threads_;
+};
+
+#endif  // HEAVY_EXECUTOR_H
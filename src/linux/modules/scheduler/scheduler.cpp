@@ -1,9 +1,18 @@
 #include <scheduler.h>
+#include <algorithm>
+
+Scheduler::Scheduler(std::size_t workers, unsigned idleSlowdown)
+    : idleSlowdown_(idleSlowdown), pool_(workers) {}
 
 void Scheduler::add(ILightModule* m) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    modules_.push_back(m);
-    nextRun_[m] = Clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        modules_.push_back({m, {}});
+        modules_.back().collectTime =
+            &metrics::histogram("collect." + std::string(m->name()) + "_ns");
+        deadlines_.push({Clock::now(), modules_.size() - 1});
+    }
+    cv_.notify_all();
 }
 
 void Scheduler::start() {
@@ -21,20 +30,111 @@ void Scheduler::stop() {
         worker_.request_stop();
 }
 
+void Scheduler::setIdle(bool idle) {
+    {
+        std::lock_guard lk(mutex_);
+        if (idle_ == idle)
+            return;
+
+        idle_ = idle;
+        if (!idle) {
+            // Resume instantly instead of waiting out the (possibly slowed) deadlines
+            decltype(deadlines_) now;
+            for (std::size_t i = 0; i < modules_.size(); ++i) {
+                modules_[i].idleTicks = 0;
+                now.push({Clock::now(), i});
+            }
+            deadlines_.swap(now);
+        }
+    }
+    cv_.notify_all();
+}
+
+std::optional<Scheduler::ModuleStats> Scheduler::stats(const ILightModule* m) {
+    std::lock_guard lk(mutex_);
+    for (const auto& state : modules_) {
+        if (state.module == m)
+            return state.stats;
+    }
+    return std::nullopt;
+}
+
 void Scheduler::run(std::stop_token st) {
+    std::unique_lock lk(mutex_);
+
     while (!st.stop_requested()) {
-        const auto now = Clock::now();
-
-        {
-            std::lock_guard lk(mutex_);
-            for (auto* m : modules_) {
-                if (now >= nextRun_[m]) {
-                    m->collect();
-                    nextRun_[m] = now + m->period();
-                }
+        if (deadlines_.empty()) {
+            cv_.wait(lk, st, [&] { return !deadlines_.empty(); });
+            continue;
+        }
+
+        // Sleep until the earliest deadline, add() wakes us if it brings an earlier one
+        const Clock::time_point next = deadlines_.top().when;
+        if (Clock::now() < next) {
+            cv_.wait_until(lk, st, next, [&] { return deadlines_.top().when < next; });
+            continue;
+        }
+
+        Deadline due = deadlines_.top();
+        deadlines_.pop();
+        ModuleState& state = modules_[due.index];
+
+        // Nobody is listening: pause, or only sample every idleSlowdown_-th tick
+        const bool skip =
+            idle_ && (idleSlowdown_ == 0 || ++state.idleTicks % idleSlowdown_ != 0);
+
+        if (!skip) {
+            // At most one collect() per module; an overrunning module skips this tick
+            // rather than piling up work behind itself
+            if (state.busy) {
+                state.stats.overruns++;
+            } else {
+                state.busy = true;
+                pool_.submit([this, &state, when = due.when] { execute(state, when); });
             }
         }
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(501));
+        deadlines_.push({nextDeadline(state, due.when, Clock::now()), due.index});
+    }
+}
+
+void Scheduler::execute(ModuleState& state, Clock::time_point deadline) {
+    const Clock::time_point started = Clock::now();
+    {
+        metrics::ScopedTimer timer(*state.collectTime);
+        state.module->collect();
     }
-}
\ No newline at end of file
+
+    std::lock_guard lk(mutex_);
+    recordJitter(state, started - deadline);
+    state.busy = false;
+}
+
+void Scheduler::recordJitter(ModuleState& state, Clock::duration jitter) {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(jitter);
+
+    state.stats.ticks++;
+    state.stats.lastJitter = us;
+    state.stats.maxJitter = std::max(state.stats.maxJitter, us);
+    state.totalJitter += us;
+    state.stats.meanJitter = state.totalJitter / state.stats.ticks;
+}
+
+Scheduler::Clock::time_point Scheduler::nextDeadline(ModuleState& state,
+                                                     Clock::time_point deadline,
+                                                     Clock::time_point now) {
+    const auto period = state.module->period();
+
+    // Fixed-rate: advance from the previous deadline, not from now, so timing errors
+    // don't accumulate. If we fell behind, drop the missed beats instead of bursting.
+    Clock::time_point next = deadline + period;
+    if (next <= now && period.count() > 0) {
+        auto missed = (now - next) / period + 1;
+        next += missed * period;
+        state.stats.missed += missed;
+    } else if (next <= now) {
+        next = now;
+    }
+
+    return next;
+}
@@ -2,16 +2,39 @@
 #define SCHEDULER_H
 
 #include <light_module.h>
+#include <metrics.h>
+#include <worker_pool.h>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <queue>
 #include <stop_token>
 #include <thread>
-#include <unordered_map>
+#include <vector>
 
 class Scheduler {
 public:
     using Clock = std::chrono::steady_clock;
 
-    Scheduler() = default;
+    // Timing statistics for one module. Jitter is how late collect() started relative
+    // to its deadline.
+    struct ModuleStats {
+        std::uint64_t ticks = 0;
+        std::uint64_t missed = 0;    // Deadlines skipped, the scheduler fell behind
+        std::uint64_t overruns = 0;  // Ticks skipped because collect() was still running
+        std::chrono::microseconds lastJitter{0};
+        std::chrono::microseconds maxJitter{0};
+        std::chrono::microseconds meanJitter{0};
+    };
+
+    // Due modules run concurrently on a pool of `workers` threads. While idle (nobody
+    // is listening) modules run only every `idleSlowdown`-th tick, 0 pauses them.
+    explicit Scheduler(std::size_t workers = std::thread::hardware_concurrency(),
+                       unsigned idleSlowdown = 0);
     ~Scheduler() = default;
 
     void add(ILightModule* m);
@@ -19,15 +42,48 @@ public:
     void start();
     void stop();
 
+    // Leaving idle makes every module due immediately
+    void setIdle(bool idle);
+
+    std::optional<ModuleStats> stats(const ILightModule* m);
+
 private:
+    struct ModuleState {
+        ILightModule* module;
+        ModuleStats stats;
+        std::chrono::microseconds totalJitter{0};
+        bool busy = false;  // A collect() is queued or running
+        unsigned idleTicks = 0;
+        metrics::Histogram* collectTime = nullptr;
+    };
+
+    struct Deadline {
+        Clock::time_point when;
+        std::size_t index;
+
+        bool operator>(const Deadline& other) const { return when > other.when; }
+    };
+
     void run(std::stop_token st);
+    void execute(ModuleState& state, Clock::time_point deadline);
+    void recordJitter(ModuleState& state, Clock::duration jitter);
+    Clock::time_point nextDeadline(ModuleState& state,
+                                   Clock::time_point deadline,
+                                   Clock::time_point now);
 
-    std::vector<ILightModule*> modules_;
-    std::unordered_map<ILightModule*, Clock::time_point> nextRun_;
+    // deque keeps references stable while add() runs during a collect()
+    std::deque<ModuleState> modules_;
+    std::priority_queue<Deadline, std::vector<Deadline>, std::greater<>> deadlines_;
 
     std::mutex mutex_;
+    std::condition_variable_any cv_;
     std::atomic<bool> running_{false};
+    bool idle_ = false;
+    unsigned idleSlowdown_;
+
+    // Destroyed after worker_, which is the only thread submitting work
+    WorkerPool pool_;
     std::jthread worker_;
 };
 
-#endif  // SCHEDULER_H
\ No newline at end of file
+#endif  // SCHEDULER_H
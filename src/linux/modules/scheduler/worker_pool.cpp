@@ -0,0 +1,43 @@
+#include <worker_pool.h>
+
+WorkerPool::WorkerPool(std::size_t threads) {
+    if (threads == 0)
+        threads = 1;
+
+    threads_.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        threads_.emplace_back([this](std::stop_token st) { run(st); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    for (auto& thread : threads_) {
+        thread.request_stop();
+    }
+    // jthread joins on destruction
+    threads_.clear();
+}
+
+void WorkerPool::submit(Task task) {
+    {
+        std::lock_guard lk(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+}
+
+void WorkerPool::run(std::stop_token st) {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock lk(mutex_);
+            if (!cv_.wait(lk, st, [&] { return !tasks_.empty(); }))
+                return;
+
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+
+        task();
+    }
+}
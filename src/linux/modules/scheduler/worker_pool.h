@@ -0,0 +1,33 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of threads executing submitted tasks in FIFO order. Pending tasks
+// are dropped when the pool is destroyed.
+class WorkerPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkerPool(std::size_t threads);
+    ~WorkerPool();
+
+    void submit(Task task);
+    std::size_t size() const { return threads_.size(); }
+
+private:
+    void run(std::stop_token st);
+
+    std::deque<Task> tasks_;
+    std::mutex mutex_;
+    std::condition_variable_any cv_;
+    std::vector<std::jthread> threads_;
+};
+
+#endif  // WORKER_POOL_H
@@ -0,0 +1,17 @@
+#include <metrics.h>
+#include <self_stats.h>
+
+SelfStats::SelfStats(EventBus& eventBus, std::chrono::milliseconds period)
+    : eventBus_(eventBus), period_(period) {}
+
+void SelfStats::collect() {
+    eventBus_.publish(metrics::snapshot());
+}
+
+std::chrono::milliseconds SelfStats::period() {
+    return period_;
+}
+
+std::string_view SelfStats::name() {
+    return "self";
+}
@@ -0,0 +1,20 @@
+#ifndef SELF_STATS_H
+#define SELF_STATS_H
+
+#include <event_bus.h>
+#include <light_module.h>
+
+// Publishes the watcher's own metrics as SELF_STATS
+class SelfStats : public ILightModule {
+public:
+    SelfStats(EventBus& eventBus, std::chrono::milliseconds period);
+    void collect() override;
+    std::chrono::milliseconds period() override;
+    std::string_view name() override;
+
+private:
+    EventBus& eventBus_;
+    std::chrono::milliseconds period_;
+};
+
+#endif  // SELF_STATS_H
@@ -35,6 +35,10 @@ std::chrono::milliseconds SystemInfo::period() {
     return period_;
 }
 
+std::string_view SystemInfo::name() {
+    return "system";
+}
+
 void SystemInfo::getHostname() {
     char name[256];
     gethostname(name, sizeof(name));
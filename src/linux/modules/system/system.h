@@ -13,6 +13,7 @@ public:
     message::MessageVariantOUT getStaticData() override;
     void collect() override;
     std::chrono::milliseconds period() override;
+    std::string_view name() override;
 
 private:
     // Static system information retrieval methods
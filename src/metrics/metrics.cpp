@@ -0,0 +1,172 @@
+#include <metrics.h>
+#include <sys/resource.h>
+#include <algorithm>
+#include <bit>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace metrics {
+    namespace {
+        struct Registry {
+            std::mutex mutex;
+            std::map<std::string, std::unique_ptr<Counter>, std::less<>> counters;
+            std::map<std::string, std::unique_ptr<Histogram>, std::less<>> histograms;
+        };
+
+        Registry& registry() {
+            static Registry instance;
+            return instance;
+        }
+
+        template <typename T>
+        T& lookup(std::map<std::string, std::unique_ptr<T>, std::less<>>& map,
+                  std::string_view name) {
+            std::lock_guard lk(registry().mutex);
+
+            auto it = map.find(name);
+            if (it == map.end())
+                it = map.emplace(std::string(name), std::make_unique<T>()).first;
+            return *it->second;
+        }
+
+        uint64_t microseconds(const timeval& tv) {
+            return static_cast<uint64_t>(tv.tv_sec) * 1000000 +
+                   static_cast<uint64_t>(tv.tv_usec);
+        }
+    }  // namespace
+
+    void Histogram::record(uint64_t value) {
+        counts_[bucketFor(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+
+        uint64_t seen = min_.load(std::memory_order_relaxed);
+        while (value < seen &&
+               !min_.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+        }
+        seen = max_.load(std::memory_order_relaxed);
+        while (value > seen &&
+               !max_.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    message::HistogramStat Histogram::summary(std::string name) const {
+        message::HistogramStat stat;
+        stat.name = std::move(name);
+
+        // Buckets are read one by one while writers keep going, so the percentiles come
+        // from the bucket totals rather than count_
+        std::array<uint64_t, kBuckets> counts;
+        uint64_t total = 0;
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            counts[i] = counts_[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+
+        stat.count = total;
+        if (total == 0)
+            return stat;
+
+        stat.min = min_.load(std::memory_order_relaxed);
+        stat.max = max_.load(std::memory_order_relaxed);
+        stat.mean = sum_.load(std::memory_order_relaxed) /
+                    std::max<uint64_t>(count_.load(std::memory_order_relaxed), 1);
+
+        const std::pair<double, uint64_t*> quantiles[] = {
+            {0.50, &stat.p50}, {0.90, &stat.p90}, {0.99, &stat.p99}};
+
+        std::size_t bucket = 0;
+        uint64_t seen = counts[0];
+        for (auto [q, out] : quantiles) {
+            const auto rank =
+                std::max<uint64_t>(static_cast<uint64_t>(q * total + 0.5), 1);
+            while (seen < rank && bucket + 1 < kBuckets) {
+                seen += counts[++bucket];
+            }
+            *out = std::clamp(valueAt(bucket), stat.min, stat.max);
+        }
+
+        return stat;
+    }
+
+    std::size_t Histogram::bucketFor(uint64_t value) {
+        if (value < kSubBuckets)
+            return value;
+
+        // The top kSubBucketBits + 1 bits pick the bucket: magnitude, then sub-bucket
+        const int msb = 63 - std::countl_zero(value);
+        const int shift = msb - kSubBucketBits;
+        const auto sub = static_cast<std::size_t>((value >> shift) - kSubBuckets);
+        return (shift + 1) * kSubBuckets + sub;
+    }
+
+    uint64_t Histogram::valueAt(std::size_t bucket) {
+        if (bucket < kSubBuckets)
+            return bucket;
+
+        // Middle of the bucket's range
+        const int shift = static_cast<int>(bucket / kSubBuckets) - 1;
+        const uint64_t low = (kSubBuckets + bucket % kSubBuckets) << shift;
+        return low + ((uint64_t{1} << shift) - 1) / 2;
+    }
+
+    Counter& counter(std::string_view name) {
+        return lookup(registry().counters, name);
+    }
+
+    Histogram& histogram(std::string_view name) {
+        return lookup(registry().histograms, name);
+    }
+
+    message::SelfStats snapshot() {
+        message::SelfStats stats;
+
+        rusage usage{};
+        if (getrusage(RUSAGE_SELF, &usage) == 0) {
+            stats.counters.push_back(
+                {"process.cpu_user_us", microseconds(usage.ru_utime)});
+            stats.counters.push_back(
+                {"process.cpu_system_us", microseconds(usage.ru_stime)});
+            stats.counters.push_back(
+                {"process.max_rss_kb", static_cast<uint64_t>(usage.ru_maxrss)});
+        }
+
+        std::lock_guard lk(registry().mutex);
+
+        for (const auto& [name, counter] : registry().counters) {
+            stats.counters.push_back({name, counter->value()});
+        }
+        for (const auto& [name, histogram] : registry().histograms) {
+            stats.histograms.push_back(histogram->summary(name));
+        }
+
+        return stats;
+    }
+
+    std::string renderText() {
+        const message::SelfStats stats = snapshot();
+        std::string out;
+
+        for (const auto& counter : stats.counters) {
+            out += counter.name + " " + std::to_string(counter.value) + "\n";
+        }
+
+        for (const auto& h : stats.histograms) {
+            const std::pair<std::string_view, uint64_t> values[] = {
+                {"count", h.count}, {"min", h.min}, {"mean", h.mean}, {"p50", h.p50},
+                {"p90", h.p90},     {"p99", h.p99}, {"max", h.max}};
+
+            for (auto [stat, value] : values) {
+                out += h.name;
+                out += '{';
+                out += stat;
+                out += "} ";
+                out += std::to_string(value);
+                out += '\n';
+            }
+        }
+
+        return out;
+    }
+}  // namespace metrics
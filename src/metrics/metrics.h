@@ -0,0 +1,79 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <json.hpp>
+#include <string>
+#include <string_view>
+
+// Self-instrumentation. Recording is lock-free (relaxed atomics), only looking a
+// metric up by name takes a lock, so hot paths resolve their metrics once and keep
+// the reference.
+namespace metrics {
+    class Counter {
+    public:
+        void add(uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+        uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<uint64_t> value_{0};
+    };
+
+    // Log-linear buckets in the style of HdrHistogram: values below 16 are exact, every
+    // power of two above is split into 16 linear sub-buckets (~6% relative error)
+    class Histogram {
+    public:
+        static constexpr int kSubBucketBits = 4;
+        static constexpr std::size_t kSubBuckets = std::size_t{1} << kSubBucketBits;
+        static constexpr std::size_t kBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+        void record(uint64_t value);
+
+        message::HistogramStat summary(std::string name) const;
+
+    private:
+        static std::size_t bucketFor(uint64_t value);
+        static uint64_t valueAt(std::size_t bucket);
+
+        std::array<std::atomic<uint64_t>, kBuckets> counts_{};
+        std::atomic<uint64_t> count_{0};
+        std::atomic<uint64_t> sum_{0};
+        std::atomic<uint64_t> min_{UINT64_MAX};
+        std::atomic<uint64_t> max_{0};
+    };
+
+    // Records the lifetime of the scope in nanoseconds
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(Histogram& histogram)
+            : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+        ~ScopedTimer() {
+            histogram_.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                  std::chrono::steady_clock::now() - start_)
+                                  .count());
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        Histogram& histogram_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    // Process-wide registry, the returned references stay valid for the process
+    // lifetime. Latencies are recorded in nanoseconds and named *_ns by convention.
+    Counter& counter(std::string_view name);
+    Histogram& histogram(std::string_view name);
+
+    // Every registered metric plus the process' own CPU time and peak RSS
+    message::SelfStats snapshot();
+
+    // snapshot() as "name value" lines, histograms as name{stat} lines
+    std::string renderText();
+}  // namespace metrics
+
+#endif  // METRICS_H
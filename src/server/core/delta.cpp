@@ -0,0 +1,118 @@
+#include <delta.h>
+#include <cmath>
+
+DeltaEncoder::DeltaEncoder(double epsilon, int keyframeInterval)
+    : epsilon_(epsilon), keyframeInterval_(keyframeInterval) {}
+
+std::optional<DeltaEncoder::Result> DeltaEncoder::encode(
+    const message::MessageVariantOUT& msg) {
+    std::lock_guard lk(mutex_);
+
+    if (const auto* cpu = std::get_if<message::CpuInfo>(&msg))
+        return encodeCpu(*cpu);
+    if (const auto* system = std::get_if<message::SystemInfo>(&msg))
+        return encodeSystem(*system);
+
+    return std::nullopt;
+}
+
+std::vector<message::MessageVariantOUT> DeltaEncoder::keyframes() {
+    std::lock_guard lk(mutex_);
+
+    std::vector<message::MessageVariantOUT> result;
+    if (systemBase_)
+        result.push_back(*systemBase_);
+    if (cpuBase_)
+        result.push_back(*cpuBase_);
+    return result;
+}
+
+void DeltaEncoder::reset() {
+    std::lock_guard lk(mutex_);
+    cpuBase_.reset();
+    systemBase_.reset();
+}
+
+DeltaEncoder::Result DeltaEncoder::encodeCpu(const message::CpuInfo& cur) {
+    if (!cpuBase_ || keyframeDue(cpuSinceKeyframe_) ||
+        cpuBase_->per_core_usage.size() != cur.per_core_usage.size()) {
+        cpuBase_ = cur;
+        cpuSinceKeyframe_ = 0;
+        return {true, {}};
+    }
+
+    message::CpuInfo& base = *cpuBase_;
+    nlohmann::json delta = {{"type", message::Type::CPU_INFO_DELTA}};
+
+    // Compare against the last *sent* value so slow drift still gets through
+    auto field = [&](const char* name, double& baseValue, double value) {
+        if (changed(baseValue, value)) {
+            delta[name] = value;
+            baseValue = value;
+        }
+    };
+
+    field("cpu_load_avg_1min", base.cpu_load_avg_1min, cur.cpu_load_avg_1min);
+    field("cpu_load_avg_5min", base.cpu_load_avg_5min, cur.cpu_load_avg_5min);
+    field("cpu_load_avg_15min", base.cpu_load_avg_15min, cur.cpu_load_avg_15min);
+    field("cpu_usage", base.cpu_usage, cur.cpu_usage);
+
+    if (base.cpu_frequency != cur.cpu_frequency) {
+        delta["cpu_frequency"] = cur.cpu_frequency;
+        base.cpu_frequency = cur.cpu_frequency;
+    }
+
+    nlohmann::json index = nlohmann::json::array();
+    nlohmann::json value = nlohmann::json::array();
+    for (std::size_t i = 0; i < cur.per_core_usage.size(); ++i) {
+        if (changed(base.per_core_usage[i], cur.per_core_usage[i])) {
+            index.push_back(i);
+            value.push_back(cur.per_core_usage[i]);
+            base.per_core_usage[i] = cur.per_core_usage[i];
+        }
+    }
+
+    if (!index.empty())
+        delta["per_core_usage"] = {{"index", std::move(index)},
+                                   {"value", std::move(value)}};
+
+    return finish(std::move(delta));
+}
+
+DeltaEncoder::Result DeltaEncoder::encodeSystem(const message::SystemInfo& cur) {
+    if (!systemBase_ || keyframeDue(systemSinceKeyframe_)) {
+        systemBase_ = cur;
+        systemSinceKeyframe_ = 0;
+        return {true, {}};
+    }
+
+    message::SystemInfo& base = *systemBase_;
+    nlohmann::json delta = {{"type", message::Type::SYSTEM_INFO_DELTA}};
+
+    if (base.uptime != cur.uptime) {
+        delta["uptime"] = cur.uptime;
+        base.uptime = cur.uptime;
+    }
+    if (base.local_time != cur.local_time) {
+        delta["local_time"] = cur.local_time;
+        base.local_time = cur.local_time;
+    }
+
+    return finish(std::move(delta));
+}
+
+DeltaEncoder::Result DeltaEncoder::finish(nlohmann::json delta) {
+    // Nothing but the type field: nothing to send this tick
+    if (delta.size() <= 1)
+        return {false, nullptr};
+
+    return {false, std::move(delta)};
+}
+
+bool DeltaEncoder::changed(double base, double cur) const {
+    return std::fabs(cur - base) > epsilon_;
+}
+
+bool DeltaEncoder::keyframeDue(int& sinceKeyframe) {
+    return keyframeInterval_ > 0 && ++sinceKeyframe >= keyframeInterval_;
+}
@@ -0,0 +1,48 @@
+#ifndef DELTA_H
+#define DELTA_H
+
+#include <json.hpp>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+// Turns a stream of full SystemInfo/CpuInfo samples into *_DELTA messages that carry
+// only the fields (and per-core indices) that moved more than epsilon since they were
+// last sent. The base snapshot holds exactly what delta clients currently believe,
+// so it doubles as the keyframe for clients that join mid-stream.
+class DeltaEncoder {
+public:
+    struct Result {
+        bool keyframe;         // Send the full message instead of a delta
+        nlohmann::json delta;  // null when nothing changed enough to be sent
+    };
+
+    DeltaEncoder(double epsilon, int keyframeInterval);
+
+    // std::nullopt for message types that have no delta form
+    std::optional<Result> encode(const message::MessageVariantOUT& msg);
+
+    // Current base snapshots, to bring a new delta subscriber in sync
+    std::vector<message::MessageVariantOUT> keyframes();
+
+    // Forces the next sample of every type to be a keyframe
+    void reset();
+
+private:
+    Result encodeCpu(const message::CpuInfo& cur);
+    Result encodeSystem(const message::SystemInfo& cur);
+    Result finish(nlohmann::json delta);
+    bool changed(double base, double cur) const;
+    bool keyframeDue(int& sinceKeyframe);
+
+    double epsilon_;
+    int keyframeInterval_;
+
+    std::mutex mutex_;
+    std::optional<message::CpuInfo> cpuBase_;
+    std::optional<message::SystemInfo> systemBase_;
+    int cpuSinceKeyframe_ = 0;
+    int systemSinceKeyframe_ = 0;
+};
+
+#endif  // DELTA_H
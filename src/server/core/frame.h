@@ -0,0 +1,27 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <json.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+// One topic publish of an already encoded payload. Payloads are shared, so channels
+// that receive identical bytes (same encoding, different rate buckets) reuse them.
+struct Publication {
+    std::string topic;
+    std::shared_ptr<const std::string> payload;
+    bool binary;
+};
+
+// Immutable, already serialized outbound message. It is encoded on the producer thread
+// once per encoding actually in use and shared by pointer, so only the bytes cross into
+// the uWS loop.
+struct Frame {
+    message::Type type;
+    std::vector<Publication> publications;
+};
+
+using FramePtr = std::shared_ptr<const Frame>;
+
+#endif  // FRAME_H
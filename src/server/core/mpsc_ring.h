@@ -0,0 +1,89 @@
+#ifndef MPSC_RING_H
+#define MPSC_RING_H
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+
+// Bounded lock-free multi-producer/single-consumer ring (Vyukov's sequence-per-cell
+// scheme). Producers claim a slot with one CAS; the single consumer needs no atomic
+// RMW at all. tryPush() fails instead of blocking when the ring is full.
+template <typename T>
+class MpscRing {
+public:
+    explicit MpscRing(std::size_t capacity)
+        : capacity_(std::bit_ceil(capacity < 2 ? 2 : capacity)),
+          mask_(capacity_ - 1),
+          cells_(std::make_unique<Cell[]>(capacity_)) {
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    // Any thread
+    bool tryPush(T value) {
+        std::size_t pos = head_.load(std::memory_order_relaxed);
+
+        while (true) {
+            Cell& cell = cells_[pos & mask_];
+            std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff =
+                static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1,
+                                                std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // Full
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer thread only
+    bool tryPop(T& out) {
+        Cell& cell = cells_[tail_ & mask_];
+        std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+
+        if (seq != tail_ + 1)
+            return false;  // Empty, or the producer has not finished writing yet
+
+        out = std::move(cell.value);
+        cell.value = T{};
+        cell.sequence.store(tail_ + capacity_, std::memory_order_release);
+        ++tail_;
+        return true;
+    }
+
+    // Approximate, for monitoring
+    std::size_t size() const {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        return head >= tail_ ? head - tail_ : 0;
+    }
+
+    std::size_t capacity() const { return capacity_; }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::size_t tail_ = 0;
+};
+
+#endif  // MPSC_RING_H
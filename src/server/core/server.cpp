@@ -1,12 +1,53 @@
 #include <server.h>
+#include <algorithm>
 #include <print>
 #include "auth.h"
 #include "json.hpp"
 
+namespace {
+    // Raw address bytes as uSockets reports them: 4 for IPv4, 16 for IPv6. The text
+    // form is not canonical, ::1 comes out as 0:0:0:0:0:0:0:1.
+    bool isLoopback(std::string_view address) {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(address.data());
+
+        if (address.size() == 4)
+            return bytes[0] == 127;
+        if (address.size() != 16)
+            return false;
+
+        // ::1
+        if (std::all_of(bytes, bytes + 15, [](unsigned char b) { return b == 0; }))
+            return bytes[15] == 1;
+
+        // 127.0.0.0/8 mapped into IPv6 as ::ffff:127.x.y.z
+        constexpr unsigned char kMapped[12] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff};
+        return std::equal(std::begin(kMapped), std::end(kMapped), bytes) &&
+               bytes[12] == 127;
+    }
+}  // namespace
+
 Server::Server(uWS::SocketContextOptions sslOptions,
                KeyStore& keystore,
-               EventBus& eventBus)
-    : sslOptions_(sslOptions), keystore_(keystore), eventBus_(eventBus) {
+               EventBus& eventBus,
+               ServerOptions options)
+    : options_(options),
+      sslOptions_(sslOptions),
+      keystore_(keystore),
+      eventBus_(eventBus) {
+    if (!options_.ticketKeysFile.empty())
+        ticketKeys_ = std::make_unique<TicketKeyStore>(options_.ticketKeysFile,
+                                                       options_.ticketKeyRotation);
+
+    for (unsigned i = 0; i < std::max(1u, options_.threads); ++i) {
+        loops_.push_back(std::make_unique<ServerLoop>(options_.sendQueueCapacity));
+    }
+
+    // Each bucket sees a different sample sequence, so each needs its own delta base
+    for (int bucket : subscriptions::kRateBuckets) {
+        deltaEncoders_[bucket] = std::make_unique<DeltaEncoder>(
+            options_.deltaEpsilon, options_.keyframeInterval);
+    }
+
     eventBus_.subscribe(
         [&](const message::MessageVariantOUT& msg) { this->broadcast(msg); });
 }
@@ -19,17 +60,29 @@ void Server::addStaticResource(IStaticResource* resource) {
     staticResources_.push_back(resource);
 }
 
+void Server::setHistoryStore(HistoryStore* history) {
+    history_ = history;
+}
+
+void Server::onListenersChanged(std::function<void(bool)> callback) {
+    listenersChanged_ = std::move(callback);
+}
+
 void Server::run(int port) {
     if (running_.load())
         return;
 
     port_ = port;
+    readyLoops_ = 0;
+    historyWorker_ = std::make_unique<WorkerPool>(1);
 
-    wsThread_ = new std::thread(&Server::start, this);
+    for (auto& loop : loops_) {
+        loop->thread = std::thread(&Server::start, this, std::ref(*loop));
+    }
 
     std::unique_lock lk(loopMutex_);
 
-    loopCv_.wait(lk, [&] { return loop_ != nullptr; });
+    loopCv_.wait(lk, [&] { return readyLoops_ == loops_.size(); });
 
     running_.store(true);
 }
@@ -38,46 +91,83 @@ void Server::stop() {
     if (!running_.load())
         return;
 
-    auto* loop = loop_.load();
-
-    if (loop) {
-        loop->defer([this] { app_->close(); });
+    for (auto& loop : loops_) {
+        if (uWS::Loop* uwsLoop = loop->loop.load())
+            uwsLoop->defer([app = loop->app] { app->close(); });
     }
 
-    if (wsThread_ && wsThread_->joinable()) {
-        wsThread_->join();
+    for (auto& loop : loops_) {
+        if (loop->thread.joinable())
+            loop->thread.join();
     }
 
-    delete wsThread_;
-    wsThread_ = nullptr;
+    // Waits for a reply being built, requests still queued are dropped
+    historyWorker_.reset();
+
     running_.store(false);
 }
 
 void Server::broadcast(const message::MessageVariantOUT& msg) {
-    {
-        std::lock_guard lk(queueMutex_);
-        sendQueue_.push(msg);
+    // Serialize on the producer thread, the loop only ever sees the finished bytes
+    FramePtr frame = encode(msg);
+    if (!frame)
+        return;
+
+    // Every loop publishes the same bytes to its own sockets
+    bool dropped = false;
+    for (auto& loop : loops_) {
+        dropped |= !enqueue(*loop, frame);
+    }
+
+    // encode() already moved the delta bases past what the dropped frame carried,
+    // deltas on top of them would be against values those clients never got
+    if (dropped) {
+        std::lock_guard lk(rateMutex_);
+        for (auto& [_, encoder] : deltaEncoders_) {
+            encoder->reset();
+        }
     }
+}
 
-    uWS::Loop* loop = loop_.load();
+bool Server::enqueue(ServerLoop& loop, FramePtr frame) {
+    if (!loop.sendQueue.tryPush(std::move(frame))) {
+        droppedFrames_.add();
+        return false;
+    }
 
-    if (!loop)
-        return;
+    uWS::Loop* uwsLoop = loop.loop.load();
 
-    if (!deferScheduled_.exchange(true)) {
-        loop->defer([this]() {
-            deferScheduled_ = false;
-            flushQueue();
+    if (!uwsLoop)
+        return true;
+
+    if (!loop.deferScheduled.exchange(true)) {
+        uwsLoop->defer([this, &loop]() {
+            loop.deferScheduled = false;
+            flushQueue(loop);
         });
     }
+
+    return true;
 }
 
-void Server::start() {
-    app_ = new uWS::SSLApp(sslOptions_);
+uint64_t Server::droppedFrames() const {
+    return droppedFrames_.value();
+}
 
-    app_->ws<PerSocketData>(
+std::map<std::string, ClientStats> Server::clientStats() {
+    std::lock_guard lk(statsMutex_);
+    return clientStats_;
+}
+
+void Server::start(ServerLoop& loop) {
+    loop.app = new uWS::SSLApp(sslOptions_);
+
+    if (ticketKeys_)
+        ticketKeys_->install(static_cast<SSL_CTX*>(loop.app->getNativeHandle()));
+
+    loop.app->ws<PerSocketData>(
             "/*",
-            {.compression = uWS::DISABLED,
+            {.compression = options_.compression,
              .maxPayloadLength = 16 * 1024 * 1024,
              .idleTimeout = 0,
              .maxBackpressure = 16 * 1024 * 1024,
@@ -85,11 +175,17 @@ void Server::start() {
              .resetIdleTimeoutOnSend = true,
              .sendPingsAutomatically = false,
              .upgrade = nullptr,
-             .open = [this](auto* ws) { onOpen(ws); },
+             .open =
+                 [this, &loop](auto* ws) {
+                     ws->getUserData()->loop = &loop;
+                     onOpen(ws);
+                 },
              .message = [this](auto* ws, std::string_view message,
                                uWS::OpCode opCode) { onMessage(ws, message, opCode); },
+             .drain = [this](auto* ws) { onDrain(ws); },
              .close = [this](auto* ws, int code,
                              std::string_view message) { onClose(ws, code, message); }})
+        .get("/stats", [this](auto* res, auto* req) { onStats(res, req); })
         .listen(port_, [this](auto* listen_socket) {
             /*if (listen_socket) {
                 std::cout << "Thread " << std::this_thread::get_id()
@@ -102,37 +198,248 @@ void Server::start() {
 
     {
         std::lock_guard lk(loopMutex_);
-        loop_ = uWS::Loop::get();
+        loop.loop = uWS::Loop::get();
+        ++readyLoops_;
     }
     loopCv_.notify_all();
 
-    app_->run();
+    loop.app->run();
 
-    delete app_;
-    app_ = nullptr;
+    loop.loop = nullptr;
+    delete loop.app;
+    loop.app = nullptr;
 
     uWS::Loop::get()->free();
 }
 
-void Server::flushQueue() {
-    if (uWS::Loop::get() != loop_.load()) {
+FramePtr Server::encode(const message::MessageVariantOUT& msg) {
+    const message::Type type = message::getMessageType(msg);
+
+    // Nobody listens for this type at any rate, don't serialize for nobody
+    std::vector<Channel> channels = subscriptions_.active(type);
+    if (channels.empty())
+        return nullptr;
+
+    // Started only now, skipped messages would pile near-zero samples into encode_ns
+    metrics::ScopedTimer timer(encodeTime_);
+
+    auto frame = std::make_shared<Frame>();
+    frame->type = type;
+
+    // Full payloads are identical across buckets, encode each encoding at most once
+    std::array<std::shared_ptr<const std::string>, message::kEncodingCount> full;
+    auto fullPayload = [&](message::Encoding encoding) {
+        auto& payload = full[static_cast<std::size_t>(encoding)];
+        if (!payload) {
+            metrics::ScopedTimer timer(serializeTime_);
+            payload = std::make_shared<const std::string>(
+                message::serializeMessage(msg, encoding));
+        }
+        return payload;
+    };
+
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard lk(rateMutex_);
+
+    for (std::size_t first = 0; first < channels.size();) {
+        const int bucket = channels[first].bucket;
+        std::size_t last = first;
+        while (last < channels.size() && channels[last].bucket == bucket)
+            ++last;
+
+        if (bucketDue(type, bucket, now)) {
+            bool deltaEncoded = false;
+            std::optional<DeltaEncoder::Result> delta;
+            std::array<std::shared_ptr<const std::string>, message::kEncodingCount>
+                deltas;
+
+            for (std::size_t i = first; i < last; ++i) {
+                const Channel& channel = channels[i];
+                std::shared_ptr<const std::string> payload;
+
+                if (channel.delta) {
+                    if (!deltaEncoded) {
+                        delta = deltaEncoders_[bucket]->encode(msg);
+                        deltaEncoded = true;
+                    }
+
+                    // No delta form or a keyframe: delta clients get the full message
+                    if (!delta || delta->keyframe) {
+                        payload = fullPayload(channel.encoding);
+                    } else if (!delta->delta.is_null()) {
+                        auto& cached = deltas[static_cast<std::size_t>(channel.encoding)];
+                        if (!cached)
+                            cached = std::make_shared<const std::string>(
+                                message::serializeJson(delta->delta, channel.encoding));
+                        payload = cached;
+                    }
+                } else {
+                    payload = fullPayload(channel.encoding);
+                }
+
+                if (payload)
+                    frame->publications.push_back(
+                        {channel.topic(), std::move(payload),
+                         channel.encoding != message::Encoding::JSON});
+            }
+        }
+
+        first = last;
+    }
+
+    if (frame->publications.empty())
+        return nullptr;
+
+    return frame;
+}
+
+bool Server::bucketDue(message::Type type,
+                       int bucket,
+                       std::chrono::steady_clock::time_point now) {
+    if (bucket == 0)
+        return true;
+
+    auto [it, inserted] = lastPublished_.try_emplace({type, bucket}, now);
+    if (inserted)
+        return true;
+
+    // Allow 10% slack so scheduler jitter doesn't push a 1 s bucket to every 2 s
+    const auto interval = std::chrono::milliseconds(bucket);
+    if (now - it->second + interval / 10 < interval)
+        return false;
+
+    it->second = now;
+    return true;
+}
+
+void Server::flushQueue(ServerLoop& loop) {
+    if (uWS::Loop::get() != loop.loop.load()) {
         std::abort();
     }
 
-    std::queue<message::MessageVariantOUT> local;
+    metrics::ScopedTimer timer(flushTime_);
+    queueDepth_.record(loop.sendQueue.size());
 
-    {
-        std::lock_guard lk(queueMutex_);
-        std::swap(local, sendQueue_);
+    FramePtr frame;
+    uint64_t batch = 0;
+
+    while (loop.sendQueue.tryPop(frame)) {
+        ++batch;
+
+        for (const Publication& publication : frame->publications) {
+            loop.app->publish(publication.topic, *publication.payload,
+                          publication.binary ? uWS::OpCode::BINARY : uWS::OpCode::TEXT,
+                          shouldCompress(*publication.payload));
+        }
+
+        // Congested sockets are off their topics, remember what they missed
+        for (auto* ws : loop.congested) {
+            coalesce(ws, *frame);
+        }
     }
 
-    while (!local.empty()) {
-        const message::MessageVariantOUT& msg = local.front();
+    flushBatch_.record(batch);
+    checkBackpressure(loop);
+}
 
-        app_->publish("info", message::serializeMessage(msg), uWS::OpCode::TEXT);
+void Server::checkBackpressure(ServerLoop& loop) {
+    for (auto* ws : loop.sockets) {
+        if (!ws->getUserData()->congested &&
+            ws->getBufferedAmount() > options_.backpressureHigh)
+            congest(ws);
+    }
+}
 
-        local.pop();
+void Server::congest(uWS::WebSocket<true, true, PerSocketData>* ws) {
+    PerSocketData* psd = ws->getUserData();
+
+    psd->congested = true;
+    psd->loop->congested.insert(ws);
+
+    for (const Channel& channel : psd->channels) {
+        ws->unsubscribe(channel.topic());
     }
+
+    updateClientStats(ws);
+}
+
+void Server::coalesce(uWS::WebSocket<true, true, PerSocketData>* ws, const Frame& frame) {
+    PerSocketData* psd = ws->getUserData();
+    bool dropped = false;
+
+    for (const Publication& publication : frame.publications) {
+        auto channel = std::ranges::find_if(psd->channels, [&](const Channel& c) {
+            return c.topic() == publication.topic;
+        });
+        if (channel == psd->channels.end())
+            continue;
+
+        // Deltas can't be coalesced, the keyframe sent on resume replaces them
+        if (channel->delta) {
+            ++psd->dropped;
+            dropped = true;
+            continue;
+        }
+
+        auto& latest = psd->pending[frame.type];
+        if (latest) {
+            ++psd->dropped;
+            dropped = true;
+        }
+        latest = publication.payload;
+    }
+
+    if (dropped)
+        updateClientStats(ws);
+}
+
+void Server::resume(uWS::WebSocket<true, true, PerSocketData>* ws) {
+    PerSocketData* psd = ws->getUserData();
+
+    psd->congested = false;
+    psd->loop->congested.erase(ws);
+
+    for (const Channel& channel : psd->channels) {
+        if (channel.delta) {
+            sendKeyframes(ws, {channel.type}, channel.bucket);
+        } else if (auto it = psd->pending.find(channel.type); it != psd->pending.end()) {
+            const std::string& payload = *it->second;
+            ws->send(payload, opCodeFor(channel.encoding), shouldCompress(payload));
+        }
+
+        ws->subscribe(channel.topic());
+    }
+
+    psd->pending.clear();
+    updateClientStats(ws);
+}
+
+void Server::updateClientStats(uWS::WebSocket<true, true, PerSocketData>* ws) {
+    PerSocketData* psd = ws->getUserData();
+
+    std::lock_guard lk(statsMutex_);
+    clientStats_[clientId(ws)] = {psd->user, psd->dropped, psd->congested};
+}
+
+std::string Server::clientId(uWS::WebSocket<true, true, PerSocketData>* ws) {
+    char uuidStr[37];
+    uuid_unparse_lower(ws->getUserData()->uuid, uuidStr);
+    return uuidStr;
+}
+
+std::string Server::replyTopic(uWS::WebSocket<true, true, PerSocketData>* ws) {
+    return "client/" + clientId(ws);
+}
+
+void Server::onStats(uWS::HttpResponse<true>* res, uWS::HttpRequest* req) {
+    // Local monitoring only, the metrics are not behind API key auth
+    if (!isLoopback(res->getRemoteAddress())) {
+        res->writeStatus("403 Forbidden")->end();
+        return;
+    }
+
+    res->writeHeader("Content-Type", "text/plain; charset=utf-8")
+        ->end(metrics::renderText());
 }
 
 void Server::onOpen(uWS::WebSocket<true, true, PerSocketData>* ws) {
@@ -142,7 +449,7 @@ void Server::onOpen(uWS::WebSocket<true, true, PerSocketData>* ws) {
     psd->nonce = auth::generateNonce();
     psd->nonceTs = std::chrono::steady_clock::now();
 
-    sendJson(ws, message::AuthChallenge{psd->nonce});
+    sendMessage(ws, message::AuthChallenge{psd->nonce});
 }
 
 void Server::onMessage(uWS::WebSocket<true, true, PerSocketData>* ws,
@@ -152,13 +459,13 @@ void Server::onMessage(uWS::WebSocket<true, true, PerSocketData>* ws,
 
     if (!psd->authenticated) {
         if (psd->nonceTs + std::chrono::seconds(5) < std::chrono::steady_clock::now()) {
-            sendJson(ws, message::Error{402, "Authentication nonce expired"});
+            sendMessage(ws, message::Error{402, "Authentication nonce expired"});
             uWS::Loop::get()->defer([ws]() { ws->close(); });
             return;
         }
 
         if (message::getMessageType(message) != message::Type::AUTH_RESPONSE) {
-            sendJson(ws, message::Error{401, "Authentication required"});
+            sendMessage(ws, message::Error{401, "Authentication required"});
             return;
         }
 
@@ -166,16 +473,38 @@ void Server::onMessage(uWS::WebSocket<true, true, PerSocketData>* ws,
         return;
     }
 
-    ws->send(message, opCode);
+    std::optional<message::MessageVariantIN> msg = message::parseMessage(message);
+    if (!msg.has_value()) {
+        sendMessage(ws, message::Error{400, "Malformed message"});
+        return;
+    }
+
+    dispatch(ws, msg.value());
+}
+
+void Server::onDrain(uWS::WebSocket<true, true, PerSocketData>* ws) {
+    if (ws->getUserData()->congested &&
+        ws->getBufferedAmount() <= options_.backpressureLow)
+        resume(ws);
 }
 
 void Server::onClose(uWS::WebSocket<true, true, PerSocketData>* ws,
                      int code,
                      std::string_view message) {
     PerSocketData* psd = ws->getUserData();
-    char uuidStr[37];
-    uuid_unparse_lower(psd->uuid, uuidStr);
-    std::print("Connection with client {} closed. Code: {}, Message: {}\n", uuidStr, code,
+    std::string id = clientId(ws);
+
+    if (psd->authenticated) {
+        unsubscribe(ws, std::exchange(psd->channels, {}));
+
+        psd->loop->sockets.erase(ws);
+        psd->loop->congested.erase(ws);
+
+        std::lock_guard lk(statsMutex_);
+        clientStats_.erase(id);
+    }
+
+    std::print("Connection with client {} closed. Code: {}, Message: {}\n", id, code,
                message);
 }
 
@@ -184,20 +513,108 @@ void Server::dispatch(uWS::WebSocket<true, true, PerSocketData>* ws,
     std::visit([&](auto&& m) { handle(ws, m); }, msg);
 }
 
-void Server::sendJson(uWS::WebSocket<true, true, PerSocketData>* ws,
-                      const message::MessageVariantOUT& msg) {
-    std::string t = message::serializeMessage(msg);
-    ws->send(message::serializeMessage(msg), uWS::OpCode::TEXT);
+void Server::sendMessage(uWS::WebSocket<true, true, PerSocketData>* ws,
+                         const message::MessageVariantOUT& msg) {
+    message::Encoding encoding = ws->getUserData()->encoding;
+    std::string payload = message::serializeMessage(msg, encoding);
+    ws->send(payload, opCodeFor(encoding), shouldCompress(payload));
 }
 
 void Server::sendFatalFailure(uWS::WebSocket<true, true, PerSocketData>* ws,
                               const message::MessageVariantOUT& error) {
-    sendJson(ws, error);
+    sendMessage(ws, error);
     uWS::Loop::get()->defer([ws]() { ws->close(); });
 }
 
 void Server::sendStaticResource(uWS::WebSocket<true, true, PerSocketData>* ws) {
     for (auto* resource : staticResources_) {
-        sendJson(ws, resource->getStaticData());
+        sendMessage(ws, resource->getStaticData());
     }
-}
\ No newline at end of file
+}
+
+void Server::subscribe(uWS::WebSocket<true, true, PerSocketData>* ws,
+                       const std::vector<message::Type>& types,
+                       int bucket) {
+    PerSocketData* psd = ws->getUserData();
+
+    for (message::Type type : types) {
+        const int channelBucket = subscriptions::isDownsampled(type) ? bucket : 0;
+        Channel channel{type, channelBucket, psd->encoding, psd->delta};
+        psd->channels.push_back(channel);
+
+        // A congested socket rejoins its topics on resume
+        if (!psd->congested)
+            ws->subscribe(channel.topic());
+
+        if (subscriptions_.add(channel) == 1)
+            updateListening();
+    }
+
+    // Deltas are relative to what other delta clients already have, start from there
+    if (psd->delta && !psd->congested)
+        sendKeyframes(ws, types, bucket);
+}
+
+void Server::unsubscribe(uWS::WebSocket<true, true, PerSocketData>* ws,
+                         const std::vector<Channel>& channels) {
+    PerSocketData* psd = ws->getUserData();
+
+    for (const Channel& channel : channels) {
+        // Keep the uWS topic if the socket re-subscribed to the same channel
+        if (!psd->congested &&
+            std::ranges::find(psd->channels, channel) == psd->channels.end())
+            ws->unsubscribe(channel.topic());
+
+        if (subscriptions_.remove(channel) == 0)
+            updateListening();
+    }
+}
+
+void Server::updateListening() {
+    // Loops race on the first/last subscriber, re-check under the lock so the
+    // callbacks can't arrive out of order
+    std::lock_guard lk(listeningMutex_);
+
+    bool listening = subscriptions_.total() > 0;
+    if (listening == listening_)
+        return;
+    listening_ = listening;
+
+    if (listening) {
+        // First listener after an idle period: drop stale delta bases so everyone
+        // restarts from a fresh keyframe, then wake the collectors up
+        std::lock_guard rateLk(rateMutex_);
+        for (auto& [_, encoder] : deltaEncoders_) {
+            encoder->reset();
+        }
+        lastPublished_.clear();
+    }
+
+    if (listenersChanged_)
+        listenersChanged_(listening);
+}
+
+void Server::sendKeyframes(uWS::WebSocket<true, true, PerSocketData>* ws,
+                           const std::vector<message::Type>& types,
+                           int bucket) {
+    std::vector<message::MessageVariantOUT> keyframes;
+    {
+        std::lock_guard lk(rateMutex_);
+        keyframes = deltaEncoders_[bucket]->keyframes();
+    }
+
+    for (const auto& keyframe : keyframes) {
+        message::Type type = message::getMessageType(keyframe);
+        if (std::ranges::find(types, type) != types.end())
+            sendMessage(ws, keyframe);
+    }
+}
+
+uWS::OpCode Server::opCodeFor(message::Encoding encoding) {
+    return encoding == message::Encoding::JSON ? uWS::OpCode::TEXT : uWS::OpCode::BINARY;
+}
+
+bool Server::shouldCompress(std::string_view payload) const {
+    return options_.compression != uWS::DISABLED &&
+           payload.size() >= options_.compressMinSize;
+}
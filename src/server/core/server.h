@@ -3,40 +3,143 @@
 #include <App.h>
 #include <api_keys.h>
 #include <event_bus.h>
+#include <history_store.h>
 #include <uuid/uuid.h>
+#include <worker_pool.h>
 #include <condition_variable>
 #include <json.hpp>
-#include <queue>
+#include <map>
+#include <metrics.h>
+#include <memory>
+#include <set>
+#include <thread>
+#include "delta.h"
+#include "frame.h"
+#include "mpsc_ring.h"
 #include "static_resource.h"
+#include "subscriptions.h"
+#include "ticket_keys.h"
+
+struct ServerLoop;
 
 struct PerSocketData {
+    ServerLoop* loop = nullptr;
     uuid_t uuid;
     bool authenticated = false;
     std::string nonce;
     std::chrono::steady_clock::time_point nonceTs;
     std::string user;
+    message::Encoding encoding = message::Encoding::JSON;
+    bool delta = false;
+    std::vector<Channel> channels;
+
+    // Backpressure: while congested the socket is off its topics and only the latest
+    // full payload per type is kept, delta channels get a keyframe on resume
+    bool congested = false;
+    std::map<message::Type, std::shared_ptr<const std::string>> pending;
+    uint64_t dropped = 0;
+};
+
+struct ClientStats {
+    std::string user;
+    uint64_t dropped = 0;
+    bool congested = false;
+};
+
+// One event loop with its own SSLApp. Every loop listens on the same port, uSockets
+// sets SO_REUSEPORT so the kernel spreads new connections across them.
+struct ServerLoop {
+    explicit ServerLoop(std::size_t queueCapacity) : sendQueue(queueCapacity) {}
+
+    std::thread thread;
+    uWS::SSLApp* app = nullptr;
+    std::atomic<uWS::Loop*> loop{nullptr};
+
+    MpscRing<FramePtr> sendQueue;
+    std::atomic_bool deferScheduled{false};
+
+    // Authenticated sockets of this loop, touched on its thread only
+    std::set<uWS::WebSocket<true, true, PerSocketData>*> sockets;
+    std::set<uWS::WebSocket<true, true, PerSocketData>*> congested;
+};
+
+struct ServerOptions {
+    // Event loops, each on its own thread. TLS handshakes and auth of a client stay
+    // on the loop that accepted it.
+    unsigned threads = 1;
+
+    // Delta mode: minimum change of a double field before it is resent, and how many
+    // ticks pass between full keyframes (0 disables periodic keyframes)
+    double deltaEpsilon = 0.05;
+    int keyframeInterval = 30;
+
+    // Frames waiting for each loop thread; producers drop (and count) when it is full
+    std::size_t sendQueueCapacity = 1024;
+
+    // Buffered bytes above which a socket stops receiving every tick, and below which
+    // it is caught up and resumed
+    unsigned int backpressureHigh = 256 * 1024;
+    unsigned int backpressureLow = 64 * 1024;
+
+    // permessage-deflate. SHARED_COMPRESSOR deflates every message from scratch with
+    // one context per loop, DEDICATED_COMPRESSOR_* keeps a window per socket so the
+    // repeated keys compress away at the cost of memory per client
+    uWS::CompressOptions compression = uWS::DISABLED;
+    // Smaller payloads are sent as-is, deflate overhead isn't worth it
+    std::size_t compressMinSize = 128;
+
+    // Session-ticket key file shared by all loops and kept across restarts so
+    // reconnecting clients resume TLS instead of a full handshake. Empty leaves
+    // OpenSSL's per-context defaults.
+    std::string ticketKeysFile;
+    std::chrono::seconds ticketKeyRotation = std::chrono::hours(12);
 };
 
 class Server {
 public:
-    Server(uWS::SocketContextOptions sslOptions, KeyStore& keystore, EventBus& eventBus);
+    Server(uWS::SocketContextOptions sslOptions,
+           KeyStore& keystore,
+           EventBus& eventBus,
+           ServerOptions options = {});
 
     ~Server();
 
     void addStaticResource(IStaticResource* resource);
 
+    // Answers HISTORY_REQUEST from this store, without one requests get an error
+    void setHistoryStore(HistoryStore* history);
+
+    // Called on a loop thread when the first client subscribes (true) or the last
+    // one goes away (false), so collection can pause while nobody listens
+    void onListenersChanged(std::function<void(bool)> callback);
+
     void run(int port);
     void stop();
     void broadcast(const message::MessageVariantOUT& msg);
 
+    // Frames dropped because a loop thread fell behind
+    uint64_t droppedFrames() const;
+
+    // Frames each authenticated client missed while congested, keyed by client uuid
+    std::map<std::string, ClientStats> clientStats();
+
 private:
-    void start();
-    void flushQueue();
+    void start(ServerLoop& loop);
+    FramePtr encode(const message::MessageVariantOUT& msg);
+    bool bucketDue(message::Type type,
+                   int bucket,
+                   std::chrono::steady_clock::time_point now);
+    // false when the loop's send queue was full and the frame was dropped
+    bool enqueue(ServerLoop& loop, FramePtr frame);
+    void flushQueue(ServerLoop& loop);
+
+    void onStats(uWS::HttpResponse<true>* res, uWS::HttpRequest* req);
 
     void onOpen(uWS::WebSocket<true, true, PerSocketData>* ws);
     void onMessage(uWS::WebSocket<true, true, PerSocketData>* ws,
                    std::string_view message,
                    uWS::OpCode opCode);
+    void onDrain(uWS::WebSocket<true, true, PerSocketData>* ws);
     void onClose(uWS::WebSocket<true, true, PerSocketData>* ws,
                  int code,
                  std::string_view message);
@@ -44,28 +147,81 @@ private:
     void dispatch(uWS::WebSocket<true, true, PerSocketData>* ws,
                   const message::MessageVariantIN& msg);
 
-    void sendJson(uWS::WebSocket<true, true, PerSocketData>* ws,
-                  const message::MessageVariantOUT& msg);
+    void sendMessage(uWS::WebSocket<true, true, PerSocketData>* ws,
+                     const message::MessageVariantOUT& msg);
 
     void sendFatalFailure(uWS::WebSocket<true, true, PerSocketData>* ws,
                           const message::MessageVariantOUT& error);
 
     void sendStaticResource(uWS::WebSocket<true, true, PerSocketData>* ws);
 
+    void subscribe(uWS::WebSocket<true, true, PerSocketData>* ws,
+                   const std::vector<message::Type>& types,
+                   int bucket);
+    void unsubscribe(uWS::WebSocket<true, true, PerSocketData>* ws,
+                     const std::vector<Channel>& channels);
+    void sendKeyframes(uWS::WebSocket<true, true, PerSocketData>* ws,
+                       const std::vector<message::Type>& types,
+                       int bucket);
+
+    void updateListening();
+
+    void checkBackpressure(ServerLoop& loop);
+    void congest(uWS::WebSocket<true, true, PerSocketData>* ws);
+    void coalesce(uWS::WebSocket<true, true, PerSocketData>* ws, const Frame& frame);
+    void resume(uWS::WebSocket<true, true, PerSocketData>* ws);
+    void updateClientStats(uWS::WebSocket<true, true, PerSocketData>* ws);
+
+    static std::string clientId(uWS::WebSocket<true, true, PerSocketData>* ws);
+    // Topic only this socket is subscribed to, for replies built off the loop thread
+    static std::string replyTopic(uWS::WebSocket<true, true, PerSocketData>* ws);
+
+    static uWS::OpCode opCodeFor(message::Encoding encoding);
+    bool shouldCompress(std::string_view payload) const;
+
     void handle(uWS::WebSocket<true, true, PerSocketData>* ws, const message::Error& msg);
 
     void handle(uWS::WebSocket<true, true, PerSocketData>* ws,
                 const message::AuthResponse& msg);
 
-    std::thread* wsThread_ = nullptr;
-    uWS::SSLApp* app_ = nullptr;
-    std::atomic<uWS::Loop*> loop_{nullptr};
+    void handle(uWS::WebSocket<true, true, PerSocketData>* ws,
+                const message::Subscribe& msg);
+
+    void handle(uWS::WebSocket<true, true, PerSocketData>* ws,
+                const message::HistoryRequest& msg);
+
+    // Built once in the constructor so producers can walk it without locking
+    std::vector<std::unique_ptr<ServerLoop>> loops_;
     std::mutex loopMutex_;
     std::condition_variable loopCv_;
-
-    std::mutex queueMutex_;
-    std::queue<message::MessageVariantOUT> sendQueue_;
-    std::atomic_bool deferScheduled_{false};
+    std::size_t readyLoops_ = 0;
+
+    // Self-metrics, see metrics.h
+    metrics::Counter& droppedFrames_ = metrics::counter("server.dropped_frames");
+    metrics::Histogram& encodeTime_ = metrics::histogram("server.encode_ns");
+    metrics::Histogram& serializeTime_ = metrics::histogram("server.serialize_ns");
+    metrics::Histogram& flushTime_ = metrics::histogram("server.flush_ns");
+    metrics::Histogram& flushBatch_ = metrics::histogram("server.flush_batch");
+    metrics::Histogram& queueDepth_ = metrics::histogram("server.queue_depth");
+    metrics::Histogram& authTime_ = metrics::histogram("server.auth_ns");
+
+    // Producers only encode for channels somebody is subscribed to
+    SubscriptionRegistry subscriptions_;
+    std::mutex listeningMutex_;
+    bool listening_ = false;
+
+    // Downsampling state per (type, bucket) and delta state per bucket, guarded by
+    // rateMutex_
+    std::mutex rateMutex_;
+    std::map<std::pair<message::Type, int>, std::chrono::steady_clock::time_point>
+        lastPublished_;
+    std::map<int, std::unique_ptr<DeltaEncoder>> deltaEncoders_;
+
+    ServerOptions options_;
+    std::unique_ptr<TicketKeyStore> ticketKeys_;
+
+    std::mutex statsMutex_;
+    std::map<std::string, ClientStats> clientStats_;
 
     std::atomic<bool> running_{false};
 
@@ -74,6 +230,11 @@ private:
     std::string host_ = "";
 
     std::vector<IStaticResource*> staticResources_;
+    HistoryStore* history_ = nullptr;
+    // Builds HISTORY_REQUEST replies, a journal read must not stall a loop. Lives
+    // from run() to stop() so no read outlives the store.
+    std::unique_ptr<WorkerPool> historyWorker_;
+    std::function<void(bool)> listenersChanged_;
 
     KeyStore& keystore_;
     EventBus& eventBus_;
@@ -1,17 +1,24 @@
 #include <server.h>
+#include <algorithm>
 #include "auth.h"
 #include "json.hpp"
 
 void Server::handle(uWS::WebSocket<true, true, PerSocketData>* ws,
                     const message::Error& msg) {
-    // For variant completeness, no specific handling needed. Users shuldn't send error
-    // messages.
-    sendJson(ws, message::Error{400, "Unknown message type"});
+    // Clients don't send ERROR, this is what parseMessage() made of a message it could
+    // not accept. Pass its reason on, so e.g. a failed encoding negotiation is visible.
+    sendMessage(ws, message::Error{400, msg.message});
 }
 
 void Server::handle(uWS::WebSocket<true, true, PerSocketData>* ws,
                     const message::AuthResponse& msg) {
     PerSocketData* psd = ws->getUserData();
+    metrics::ScopedTimer timer(authTime_);
+
+    if (psd->authenticated) {
+        sendMessage(ws, message::Error{400, "Already authenticated"});
+        return;
+    }
 
     // Extract user and HMAC from the message
     // Format assumed: "user_hmac"
@@ -41,11 +48,101 @@ void Server::handle(uWS::WebSocket<true, true, PerSocketData>* ws,
         // Authentication successful
         psd->authenticated = true;
         psd->user = user;
-        sendJson(ws, message::AuthResult{true, "Authentication successful"});
+        sendMessage(ws, message::AuthResult{true, "Authentication successful"});
+
+        // AUTH_RESULT still goes out as JSON, the requested encoding applies after it
+        psd->encoding = msg.encoding;
+        psd->delta = msg.delta;
+
         sendStaticResource(ws);
-        ws->subscribe("info");
+
+        psd->loop->sockets.insert(ws);
+        ws->subscribe(replyTopic(ws));
+        updateClientStats(ws);
+
+        // Raw streams at full rate until the client picks its own with SUBSCRIBE
+        subscribe(ws, subscriptions::defaultStreamTypes(), 0);
     } else {
         // Authentication failed
         sendFatalFailure(ws, message::AuthResult{false, "Authentication failed"});
     }
 }
+
+void Server::handle(uWS::WebSocket<true, true, PerSocketData>* ws,
+                    const message::Subscribe& msg) {
+    for (message::Type type : msg.types) {
+        if (!subscriptions::isStreamType(type)) {
+            sendMessage(ws, message::Error{400, "Type cannot be subscribed to"});
+            return;
+        }
+    }
+
+    // Subscribe before unsubscribing so switching streams never looks like the last
+    // listener leaving
+    PerSocketData* psd = ws->getUserData();
+    std::vector<Channel> previous = std::exchange(psd->channels, {});
+    subscribe(ws, msg.types, subscriptions::bucketFor(msg.interval_ms));
+    unsubscribe(ws, previous);
+}
+
+void Server::handle(uWS::WebSocket<true, true, PerSocketData>* ws,
+                    const message::HistoryRequest& msg) {
+    if (!history_) {
+        sendMessage(ws, message::Error{404, "History is not available"});
+        return;
+    }
+
+    for (message::Type type : msg.types) {
+        if (!HistoryStore::recorded(type)) {
+            sendMessage(ws, message::Error{400, "Type has no history"});
+            return;
+        }
+    }
+
+    // Every recorded type has been checked above, and CPU_INFO is the only one so far.
+    // An empty list gets an answer too, clients wait for one per request.
+    if (std::ranges::find(msg.types, message::Type::CPU_INFO) == msg.types.end()) {
+        sendMessage(ws, message::Error{400, "No history type requested"});
+        return;
+    }
+
+    const auto window = std::chrono::seconds(
+        std::clamp<int64_t>(msg.seconds, 0, history_->retention().count()));
+
+    // The whole window goes out as one columnar frame. It is built on the worker and
+    // comes back through the send queue on the socket's reply topic, which is gone if
+    // the client disconnected in the meantime.
+    PerSocketData* psd = ws->getUserData();
+    historyWorker_->submit([this, &loop = *psd->loop, topic = replyTopic(ws),
+                            encoding = psd->encoding, window] {
+        auto reply = [&](const message::MessageVariantOUT& out) {
+            auto frame = std::make_shared<Frame>();
+            frame->type = message::getMessageType(out);
+            frame->publications.push_back(
+                {topic,
+                 std::make_shared<const std::string>(
+                     message::serializeMessage(out, encoding)),
+                 encoding != message::Encoding::JSON});
+            return frame;
+        };
+
+        if (enqueue(loop, reply(history_->cpu(window))))
+            return;
+
+        // The send queue is full. A short error goes around it through defer(), so
+        // the client learns to retry instead of waiting for a reply that was dropped.
+        uWS::Loop* uwsLoop = loop.loop.load();
+        if (!uwsLoop)
+            return;
+
+        FramePtr busy = reply(message::Error{503, "Server busy, retry the request"});
+        uwsLoop->defer([this, &loop, busy] {
+            for (const Publication& publication : busy->publications) {
+                loop.app->publish(publication.topic, *publication.payload,
+                                  publication.binary ? uWS::OpCode::BINARY
+                                                     : uWS::OpCode::TEXT,
+                                  shouldCompress(*publication.payload));
+            }
+        });
+    });
+}
@@ -0,0 +1,73 @@
+#include <subscriptions.h>
+#include <algorithm>
+
+namespace subscriptions {
+    int bucketFor(int intervalMs) {
+        int bucket = kRateBuckets.front();
+        for (int b : kRateBuckets) {
+            if (b <= intervalMs)
+                bucket = b;
+        }
+        return bucket;
+    }
+
+    bool isStreamType(message::Type type) {
+        auto types = streamTypes();
+        return std::find(types.begin(), types.end(), type) != types.end();
+    }
+
+    std::vector<message::Type> streamTypes() {
+        return {message::Type::SYSTEM_INFO, message::Type::CPU_INFO,
+                message::Type::MEM_INFO,    message::Type::DISK_INFO,
+                message::Type::NET_INFO,    message::Type::PROCESS_INFO,
+                message::Type::CPU_ROLLUP,  message::Type::SELF_STATS};
+    }
+
+    std::vector<message::Type> defaultStreamTypes() {
+        return {message::Type::SYSTEM_INFO, message::Type::CPU_INFO,
+                message::Type::MEM_INFO};
+    }
+
+    bool isDownsampled(message::Type type) {
+        return type != message::Type::CPU_ROLLUP;
+    }
+}  // namespace subscriptions
+
+std::string Channel::topic() const {
+    return std::string(message::typeName(type)) + "/" + std::to_string(bucket) + "/" +
+           std::string(message::encodingName(encoding)) + (delta ? "/delta" : "");
+}
+
+int SubscriptionRegistry::add(const Channel& channel) {
+    std::lock_guard lk(mutex_);
+    counts_[channel]++;
+    return ++total_;
+}
+
+int SubscriptionRegistry::remove(const Channel& channel) {
+    std::lock_guard lk(mutex_);
+    auto it = counts_.find(channel);
+    if (it == counts_.end())
+        return total_;
+
+    if (--it->second <= 0)
+        counts_.erase(it);
+    return --total_;
+}
+
+int SubscriptionRegistry::total() {
+    std::lock_guard lk(mutex_);
+    return total_;
+}
+
+std::vector<Channel> SubscriptionRegistry::active(message::Type type) {
+    std::lock_guard lk(mutex_);
+
+    // Channels sort by type first, so all channels of a type are one contiguous range
+    std::vector<Channel> result;
+    for (auto it = counts_.lower_bound(Channel{type, 0, message::Encoding::JSON, false});
+         it != counts_.end() && it->first.type == type; ++it) {
+        result.push_back(it->first);
+    }
+    return result;
+}
@@ -0,0 +1,63 @@
+#ifndef SUBSCRIPTIONS_H
+#define SUBSCRIPTIONS_H
+
+#include <array>
+#include <compare>
+#include <json.hpp>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace subscriptions {
+    // Downsampling buckets in milliseconds, 0 means every sample. A client's requested
+    // interval is rounded down to the nearest bucket so it never gets less than asked.
+    inline constexpr std::array<int, 6> kRateBuckets = {0,     1000,  5000,
+                                                        10000, 30000, 60000};
+
+    int bucketFor(int intervalMs);
+
+    // Periodic message types a client can subscribe to
+    bool isStreamType(message::Type type);
+    std::vector<message::Type> streamTypes();
+
+    // What a client receives right after authenticating, until it sends SUBSCRIBE
+    std::vector<message::Type> defaultStreamTypes();
+
+    // Whether rate buckets apply. Rollups are already aggregated, and windows of
+    // different lengths close at the same instant, so they always go out at bucket 0.
+    bool isDownsampled(message::Type type);
+}  // namespace subscriptions
+
+// One uWS topic: a message type at a rate bucket in one wire encoding, full or delta
+struct Channel {
+    message::Type type;
+    int bucket;
+    message::Encoding encoding;
+    bool delta;
+
+    auto operator<=>(const Channel&) const = default;
+
+    // e.g. "CPU_INFO/1000/json/delta"
+    std::string topic() const;
+};
+
+// Subscriber counts per channel, maintained on the loop thread and read by producers
+// so they only encode what somebody will receive
+class SubscriptionRegistry {
+public:
+    // Both return the total number of subscriptions afterwards
+    int add(const Channel& channel);
+    int remove(const Channel& channel);
+    int total();
+
+    // Channels of the given type with at least one subscriber, ordered by bucket
+    std::vector<Channel> active(message::Type type);
+
+private:
+    std::mutex mutex_;
+    std::map<Channel, int> counts_;
+    int total_ = 0;
+};
+
+#endif  // SUBSCRIPTIONS_H
@@ -0,0 +1,199 @@
+#include <fcntl.h>
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+#include <openssl/rand.h>
+#include <sys/stat.h>
+#include <ticket_keys.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <print>
+#include <span>
+#include <stdexcept>
+
+namespace {
+    int storeIndex() {
+        static const int index =
+            SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+        return index;
+    }
+
+    int64_t nowSeconds() {
+        return std::chrono::duration_cast<std::chrono::seconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+}  // namespace
+
+TicketKeyStore::TicketKeyStore(std::string path, std::chrono::seconds rotation)
+    : path_(std::move(path)), rotation_(std::max<int64_t>(rotation.count(), 1)) {
+    const int64_t now = nowSeconds();
+
+    if (!load()) {
+        current_ = generate(now);
+        previous_ = generate(now);
+        save(current_, previous_);
+    }
+
+    rotate(now);
+    rotator_ = std::jthread([this](std::stop_token st) { run(st); });
+}
+
+void TicketKeyStore::install(SSL_CTX* ctx) {
+    SSL_CTX_set_ex_data(ctx, storeIndex(), this);
+
+    // Session ids only resume on the loop that issued them, tickets work everywhere
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER);
+    SSL_CTX_sess_set_cache_size(ctx, 4096);
+    SSL_CTX_set_timeout(ctx, static_cast<long>(2 * rotation_));
+
+    SSL_CTX_set_tlsext_ticket_key_evp_cb(ctx, &TicketKeyStore::ticketCallback);
+}
+
+int TicketKeyStore::ticketCallback(SSL* ssl,
+                                   unsigned char* keyName,
+                                   unsigned char* iv,
+                                   EVP_CIPHER_CTX* cipher,
+                                   EVP_MAC_CTX* mac,
+                                   int encrypt) {
+    auto* store = static_cast<TicketKeyStore*>(
+        SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), storeIndex()));
+    if (!store)
+        return -1;
+
+    return store->onTicket(keyName, iv, cipher, mac, encrypt);
+}
+
+int TicketKeyStore::onTicket(unsigned char* keyName,
+                             unsigned char* iv,
+                             EVP_CIPHER_CTX* cipher,
+                             EVP_MAC_CTX* mac,
+                             int encrypt) {
+    std::lock_guard lk(mutex_);
+
+    const EVP_CIPHER* aes = EVP_aes_256_cbc();
+    const Key* key = nullptr;
+    int result = 1;
+
+    if (encrypt) {
+        key = &current_;
+
+        std::ranges::copy(key->name, keyName);
+        if (RAND_bytes(iv, EVP_CIPHER_get_iv_length(aes)) != 1)
+            return -1;
+        if (EVP_EncryptInit_ex(cipher, aes, nullptr, key->aes.data(), iv) != 1)
+            return -1;
+    } else {
+        if (std::ranges::equal(current_.name, std::span(keyName, 16))) {
+            key = &current_;
+        } else if (std::ranges::equal(previous_.name, std::span(keyName, 16))) {
+            key = &previous_;
+            result = 2;  // Valid, but have the client renew it under the current key
+        } else {
+            return 0;  // Unknown or expired key, fall back to a full handshake
+        }
+
+        if (EVP_DecryptInit_ex(cipher, aes, nullptr, key->aes.data(), iv) != 1)
+            return -1;
+    }
+
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY,
+                                          const_cast<unsigned char*>(key->hmac.data()),
+                                          key->hmac.size()),
+        OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST,
+                                         const_cast<char*>("SHA256"), 0),
+        OSSL_PARAM_construct_end(),
+    };
+
+    if (EVP_MAC_CTX_set_params(mac, params) != 1)
+        return -1;
+
+    return result;
+}
+
+TicketKeyStore::Key TicketKeyStore::generate(int64_t now) {
+    Key key;
+    key.created = now;
+
+    if (RAND_bytes(key.name.data(), key.name.size()) != 1 ||
+        RAND_bytes(key.aes.data(), key.aes.size()) != 1 ||
+        RAND_bytes(key.hmac.data(), key.hmac.size()) != 1)
+        throw std::runtime_error("Failed to generate TLS ticket key");
+
+    return key;
+}
+
+void TicketKeyStore::rotate(int64_t now) {
+    Key current;
+    {
+        std::lock_guard lk(mutex_);
+        if (now - current_.created < rotation_)
+            return;
+        current = current_;
+    }
+
+    // Down for more than two periods: nothing issued with the old keys is still valid
+    const Key previous = now - current.created < 2 * rotation_ ? current : generate(now);
+    const Key next = generate(now);
+
+    // On disk before first use, a restart never loses a key that issued tickets
+    save(next, previous);
+
+    std::lock_guard lk(mutex_);
+    current_ = next;
+    previous_ = previous;
+}
+
+void TicketKeyStore::run(std::stop_token st) {
+    while (!st.stop_requested()) {
+        {
+            std::unique_lock lk(mutex_);
+            const std::chrono::sys_seconds due(
+                std::chrono::seconds(current_.created + rotation_));
+            cv_.wait_until(lk, st, due, [] { return false; });
+        }
+
+        if (!st.stop_requested())
+            rotate(nowSeconds());
+    }
+}
+
+bool TicketKeyStore::load() {
+    int fd = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    Key keys[2];
+    ssize_t n = ::read(fd, keys, sizeof(keys));
+    ::close(fd);
+
+    if (n != static_cast<ssize_t>(sizeof(keys)))
+        return false;
+
+    current_ = keys[0];
+    previous_ = keys[1];
+    return true;
+}
+
+void TicketKeyStore::save(const Key& current, const Key& previous) {
+    // Write next to the target and rename, a crash never leaves a torn key file
+    const std::string tmp = path_ + ".tmp";
+
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        std::print(stderr, "Failed to persist TLS ticket keys to {}\n", path_);
+        return;
+    }
+
+    const Key keys[2] = {current, previous};
+    bool ok = ::write(fd, keys, sizeof(keys)) == static_cast<ssize_t>(sizeof(keys));
+    ok = ::fchmod(fd, 0600) == 0 && ok;
+    ok = ::fsync(fd) == 0 && ok;
+    ::close(fd);
+
+    if (!ok || ::rename(tmp.c_str(), path_.c_str()) != 0) {
+        ::unlink(tmp.c_str());
+        std::print(stderr, "Failed to persist TLS ticket keys to {}\n", path_);
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef TICKET_KEYS_H
+#define TICKET_KEYS_H
+
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+
+// TLS session-ticket keys shared by every loop's SSL_CTX and persisted to disk, so a
+// ticket issued by one loop (or before a restart) resumes on any other. The current
+// key encrypts new tickets, the previous one still decrypts until it ages out.
+// Rotation and the fsync'd write run on a background thread; handshakes only ever
+// wait for the key swap.
+class TicketKeyStore {
+public:
+    TicketKeyStore(std::string path, std::chrono::seconds rotation);
+
+    TicketKeyStore(const TicketKeyStore&) = delete;
+    TicketKeyStore& operator=(const TicketKeyStore&) = delete;
+
+    // Enable the server session cache and ticket callback on a context
+    void install(SSL_CTX* ctx);
+
+private:
+    struct Key {
+        std::array<unsigned char, 16> name{};
+        std::array<unsigned char, 32> aes{};
+        std::array<unsigned char, 32> hmac{};
+        int64_t created = 0;  // Seconds since epoch
+    };
+
+    static int ticketCallback(SSL* ssl,
+                              unsigned char* keyName,
+                              unsigned char* iv,
+                              EVP_CIPHER_CTX* cipher,
+                              EVP_MAC_CTX* mac,
+                              int encrypt);
+    int onTicket(unsigned char* keyName,
+                 unsigned char* iv,
+                 EVP_CIPHER_CTX* cipher,
+                 EVP_MAC_CTX* mac,
+                 int encrypt);
+
+    static Key generate(int64_t now);
+    void rotate(int64_t now);
+    void run(std::stop_token st);
+    bool load();
+    void save(const Key& current, const Key& previous);
+
+    std::string path_;
+    int64_t rotation_;
+
+    std::mutex mutex_;
+    std::condition_variable_any cv_;
+    Key current_;
+    Key previous_;
+
+    std::jthread rotator_;
+};
+
+#endif  // TICKET_KEYS_H
@@ -2,40 +2,114 @@
 #define JSON_H
 
 #include <nlohmann/json.hpp>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <variant>
+#include "json_writer.hpp"
+
+// Every message type and its wire value, in one place. The enum, its JSON names and
+// typeName() are all generated from this list.
+#define MESSAGE_TYPES(X)     \
+    X(UNKNOWN, -1)           \
+    X(ERROR, 0)              \
+    X(AUTH_CHALLENGE, 1)     \
+    X(AUTH_RESPONSE, 2)      \
+    X(AUTH_RESULT, 3)        \
+    X(SYSTEM_INFO_STATIC, 4) \
+    X(SYSTEM_INFO, 5)        \
+    X(CPU_INFO_STATIC, 6)    \
+    X(CPU_INFO, 7)           \
+    X(SYSTEM_INFO_DELTA, 8)  \
+    X(CPU_INFO_DELTA, 9)     \
+    X(SUBSCRIBE, 10)         \
+    X(HISTORY_REQUEST, 11)   \
+    X(CPU_HISTORY, 12)       \
+    X(CPU_ROLLUP, 13)        \
+    X(SELF_STATS, 14)        \
+    X(MEM_INFO_STATIC, 15)   \
+    X(MEM_INFO, 16)          \
+    X(DISK_INFO_STATIC, 17)  \
+    X(DISK_INFO, 18)         \
+    X(NET_INFO, 19)          \
+    X(PROCESS_INFO, 20)
 
 // Message definitions
 namespace message {
     enum class Type {
-        UNKNOWN = -1,
-        ERROR = 0,
-        AUTH_CHALLENGE = 1,
-        AUTH_RESPONSE = 2,
-        AUTH_RESULT = 3,
-        SYSTEM_INFO_STATIC = 4,
-        SYSTEM_INFO = 5,
-        CPU_INFO_STATIC = 6,
-        CPU_INFO = 7,
-    };
-
-    NLOHMANN_JSON_SERIALIZE_ENUM(Type,
+#define MESSAGE_TYPE_ENUMERATOR(name, value) name = value,
+        MESSAGE_TYPES(MESSAGE_TYPE_ENUMERATOR)
+#undef MESSAGE_TYPE_ENUMERATOR
+    };
+
+    // Unknown names parse as the first entry, UNKNOWN
+#define MESSAGE_TYPE_NAME_PAIR(name, value) {Type::name, #name},
+    NLOHMANN_JSON_SERIALIZE_ENUM(Type, {MESSAGE_TYPES(MESSAGE_TYPE_NAME_PAIR)})
+#undef MESSAGE_TYPE_NAME_PAIR
+
+    inline std::string_view typeName(Type type) {
+        switch (type) {
+#define MESSAGE_TYPE_CASE(name, value) \
+    case Type::name:                   \
+        return #name;
+            MESSAGE_TYPES(MESSAGE_TYPE_CASE)
+#undef MESSAGE_TYPE_CASE
+        }
+        return "UNKNOWN";
+    }
+
+    inline void writeJson(JsonWriter& writer, Type type) {
+        writer.value(typeName(type));
+    }
+
+    // Wire encoding a client selects in AUTH_RESPONSE. Everything after AUTH_RESULT is
+    // sent in that encoding; binary encodings go out as binary websocket frames.
+    enum class Encoding {
+        JSON = 0,
+        MSGPACK = 1,
+        CBOR = 2,
+    };
+
+    inline constexpr std::size_t kEncodingCount = 3;
+
+    // Unknown names fall back to the first entry, i.e. JSON
+    NLOHMANN_JSON_SERIALIZE_ENUM(Encoding,
                                  {
-                                     {Type::UNKNOWN, "UNKNOWN"},
-                                     {Type::ERROR, "ERROR"},
-                                     {Type::AUTH_CHALLENGE, "AUTH_CHALLENGE"},
-                                     {Type::AUTH_RESPONSE, "AUTH_RESPONSE"},
-                                     {Type::AUTH_RESULT, "AUTH_RESULT"},
-                                     {Type::SYSTEM_INFO_STATIC, "SYSTEM_INFO_STATIC"},
-                                     {Type::SYSTEM_INFO, "SYSTEM_INFO"},
-                                     {Type::CPU_INFO_STATIC, "CPU_INFO_STATIC"},
-                                     {Type::CPU_INFO, "CPU_INFO"},
+                                     {Encoding::JSON, "json"},
+                                     {Encoding::MSGPACK, "msgpack"},
+                                     {Encoding::CBOR, "cbor"},
                                  })
 
+    inline std::string_view encodingName(Encoding encoding) {
+        switch (encoding) {
+            case Encoding::MSGPACK:
+                return "msgpack";
+            case Encoding::CBOR:
+                return "cbor";
+            default:
+                return "json";
+        }
+    }
+
+    // False for names this server doesn't speak
+    inline bool encodingFromName(std::string_view name, Encoding& encoding) {
+        for (Encoding candidate : {Encoding::JSON, Encoding::MSGPACK, Encoding::CBOR}) {
+            if (encodingName(candidate) == name) {
+                encoding = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline void writeJson(JsonWriter& writer, Encoding encoding) {
+        writer.value(encodingName(encoding));
+    }
+
     struct Message {
         Type type;
     };
-    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Message, type)
+    MESSAGE_DEFINE_TYPE(Message, type)
 
     struct Error : public Message {
         int code;
@@ -44,7 +118,7 @@ namespace message {
         Error(int code, const std::string& message)
             : Message(Type::ERROR), code(code), message(message) {}
     };
-    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Error, type, code, message);
+    MESSAGE_DEFINE_TYPE(Error, type, code, message);
 
     struct AuthChallenge : public Message {
         std::string nonce;
@@ -52,15 +126,69 @@ namespace message {
         AuthChallenge(const std::string& nonce)
             : Message(Type::AUTH_CHALLENGE), nonce(nonce) {}
     };
-    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(AuthChallenge, type, nonce);
+    MESSAGE_DEFINE_TYPE(AuthChallenge, type, nonce);
 
+    // delta: receive SYSTEM_INFO_DELTA/CPU_INFO_DELTA with changed fields only, plus a
+    // periodic full keyframe, instead of the full message every tick
     struct AuthResponse : public Message {
         std::string hmac;
+        Encoding encoding = Encoding::JSON;
+        bool delta = false;
         AuthResponse() = default;
-        AuthResponse(const std::string& hmac)
-            : Message(Type::AUTH_RESPONSE), hmac(hmac) {}
+        AuthResponse(const std::string& hmac,
+                     Encoding encoding = Encoding::JSON,
+                     bool delta = false)
+            : Message(Type::AUTH_RESPONSE),
+              hmac(hmac),
+              encoding(encoding),
+              delta(delta) {}
     };
-    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(AuthResponse, type, hmac);
+    MESSAGE_DEFINE_WRITER(AuthResponse, type, hmac, encoding, delta);
+
+    inline void to_json(nlohmann::json& j, const AuthResponse& msg) {
+        j = {{"type", msg.type},
+             {"hmac", msg.hmac},
+             {"encoding", msg.encoding},
+             {"delta", msg.delta}};
+    }
+
+    // hmac is required. encoding and delta may be left out by clients that predate them,
+    // but an encoding that is present has to name one this server speaks.
+    inline void from_json(const nlohmann::json& j, AuthResponse& msg) {
+        j.at("type").get_to(msg.type);
+        j.at("hmac").get_to(msg.hmac);
+
+        msg.encoding = Encoding::JSON;
+        if (auto it = j.find("encoding"); it != j.end()) {
+            const auto& name = it->get_ref<const std::string&>();
+            if (!encodingFromName(name, msg.encoding))
+                throw std::invalid_argument("Unknown encoding \"" + name + '"');
+        }
+
+        msg.delta = j.value("delta", false);
+    }
+
+    // Replaces the client's stream subscriptions: only the listed message types, at most
+    // one message per interval_ms (rounded down to the server's rate buckets)
+    struct Subscribe : public Message {
+        std::vector<Type> types;
+        int interval_ms = 0;
+        Subscribe() = default;
+        Subscribe(const std::vector<Type>& types, int interval_ms)
+            : Message(Type::SUBSCRIBE), types(types), interval_ms(interval_ms) {}
+    };
+    MESSAGE_DEFINE_TYPE_WITH_DEFAULT(Subscribe, type, types, interval_ms);
+
+    // Asks for the recorded samples of the listed stream types over the last `seconds`
+    struct HistoryRequest : public Message {
+        std::vector<Type> types;
+        int seconds = 300;
+
+        HistoryRequest() = default;
+        HistoryRequest(const std::vector<Type>& types, int seconds)
+            : Message(Type::HISTORY_REQUEST), types(types), seconds(seconds) {}
+    };
+    MESSAGE_DEFINE_TYPE_WITH_DEFAULT(HistoryRequest, type, types, seconds);
 
     struct AuthResult : public Message {
         bool success;
@@ -69,7 +197,7 @@ namespace message {
         AuthResult(bool success, const std::string& reason)
             : Message(Type::AUTH_RESULT), success(success), reason(reason) {}
     };
-    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(AuthResult, type, success, reason);
+    MESSAGE_DEFINE_TYPE(AuthResult, type, success, reason);
 
     struct SystemInfoStatic : public Message {
         std::string hostname;
@@ -90,13 +218,13 @@ namespace message {
               kernel_version(kernel_version),
               timezone(timezone) {}
     };
-    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(SystemInfoStatic,
-                                       type,
-                                       hostname,
-                                       system_name,
-                                       version_id,
-                                       kernel_version,
-                                       timezone);
+    MESSAGE_DEFINE_TYPE(SystemInfoStatic,
+                        type,
+                        hostname,
+                        system_name,
+                        version_id,
+                        kernel_version,
+                        timezone);
 
     struct SystemInfo : public Message {
         std::string uptime;
@@ -105,7 +233,7 @@ namespace message {
         SystemInfo(const std::string& uptime, const std::string& local_time)
             : Message(Type::SYSTEM_INFO), uptime(uptime), local_time(local_time) {}
     };
-    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(SystemInfo, type, uptime, local_time);
+    MESSAGE_DEFINE_TYPE(SystemInfo, type, uptime, local_time);
 
     struct CpuInfoStatic : public Message {
         std::string cpu_model;
@@ -126,13 +254,13 @@ namespace message {
               cpu_cores(cpu_cores),
               cpu_threads(cpu_threads) {}
     };
-    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(CpuInfoStatic,
-                                       type,
-                                       cpu_model,
-                                       cpu_architecture,
-                                       cpu_max_frequency,
-                                       cpu_cores,
-                                       cpu_threads);
+    MESSAGE_DEFINE_TYPE(CpuInfoStatic,
+                        type,
+                        cpu_model,
+                        cpu_architecture,
+                        cpu_max_frequency,
+                        cpu_cores,
+                        cpu_threads);
 
     struct CpuInfo : public Message {
         double cpu_load_avg_1min;
@@ -156,36 +284,288 @@ namespace message {
               per_core_usage(per_core_usage),
               cpu_frequency(cpu_frequency) {}
     };
-    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(CpuInfo,
-                                       type,
-                                       cpu_load_avg_1min,
-                                       cpu_load_avg_5min,
-                                       cpu_load_avg_15min,
-                                       cpu_usage,
-                                       per_core_usage,
-                                       cpu_frequency);
+    MESSAGE_DEFINE_TYPE(CpuInfo,
+                        type,
+                        cpu_load_avg_1min,
+                        cpu_load_avg_5min,
+                        cpu_load_avg_15min,
+                        cpu_usage,
+                        per_core_usage,
+                        cpu_frequency);
+
+    // Reply to HISTORY_REQUEST for CPU_INFO: one column per CpuInfo field, oldest sample
+    // first. timestamps are milliseconds since the epoch, per_core_usage[core][sample].
+    struct CpuHistory : public Message {
+        std::vector<int64_t> timestamps;
+        std::vector<double> cpu_load_avg_1min;
+        std::vector<double> cpu_load_avg_5min;
+        std::vector<double> cpu_load_avg_15min;
+        std::vector<double> cpu_usage;
+        std::vector<std::vector<double>> per_core_usage;
+        std::vector<int> cpu_frequency;
+
+        CpuHistory() : Message(Type::CPU_HISTORY) {}
+    };
+    MESSAGE_DEFINE_TYPE(CpuHistory,
+                        type,
+                        timestamps,
+                        cpu_load_avg_1min,
+                        cpu_load_avg_5min,
+                        cpu_load_avg_15min,
+                        cpu_usage,
+                        per_core_usage,
+                        cpu_frequency);
+
+    struct RollupStats {
+        double min = 0;
+        double max = 0;
+        double avg = 0;
+        double p95 = 0;
+    };
+    MESSAGE_DEFINE_TYPE(RollupStats, min, max, avg, p95);
+
+    // Summary of one closed aggregation window of CpuInfo samples. window_s is the
+    // window length, start its first millisecond since the epoch.
+    struct CpuRollup : public Message {
+        int window_s = 0;
+        int64_t start = 0;
+        int samples = 0;
+        RollupStats cpu_load_avg_1min;
+        RollupStats cpu_load_avg_5min;
+        RollupStats cpu_load_avg_15min;
+        RollupStats cpu_usage;
+        RollupStats cpu_frequency;
+        std::vector<RollupStats> per_core_usage;
+
+        CpuRollup() : Message(Type::CPU_ROLLUP) {}
+    };
+    MESSAGE_DEFINE_TYPE(CpuRollup,
+                        type,
+                        window_s,
+                        start,
+                        samples,
+                        cpu_load_avg_1min,
+                        cpu_load_avg_5min,
+                        cpu_load_avg_15min,
+                        cpu_usage,
+                        cpu_frequency,
+                        per_core_usage);
+
+    struct CounterStat {
+        std::string name;
+        uint64_t value = 0;
+    };
+    MESSAGE_DEFINE_TYPE(CounterStat, name, value);
+
+    struct HistogramStat {
+        std::string name;
+        uint64_t count = 0;
+        uint64_t min = 0;
+        uint64_t mean = 0;
+        uint64_t p50 = 0;
+        uint64_t p90 = 0;
+        uint64_t p99 = 0;
+        uint64_t max = 0;
+    };
+    MESSAGE_DEFINE_TYPE(HistogramStat, name, count, min, mean, p50, p90, p99, max);
+
+    // The watcher's own cost: collector, serializer, fan-out and auth timings (names
+    // ending in _ns are nanoseconds) and process CPU time
+    struct SelfStats : public Message {
+        std::vector<CounterStat> counters;
+        std::vector<HistogramStat> histograms;
+
+        SelfStats() : Message(Type::SELF_STATS) {}
+    };
+    MESSAGE_DEFINE_TYPE(SelfStats, type, counters, histograms);
+
+    // Sizes in kB, as /proc/meminfo reports them
+    struct MemInfoStatic : public Message {
+        int64_t mem_total;
+        int64_t swap_total;
+        MemInfoStatic() = default;
+        MemInfoStatic(int64_t mem_total, int64_t swap_total)
+            : Message(Type::MEM_INFO_STATIC),
+              mem_total(mem_total),
+              swap_total(swap_total) {}
+    };
+    MESSAGE_DEFINE_TYPE(MemInfoStatic, type, mem_total, swap_total);
+
+    // Sizes in kB, usages in percent. major_faults is per second, pressure_* are the
+    // PSI "some"/"full" stall percentages over 10 s and 60 s (0 without PSI support).
+    struct MemInfo : public Message {
+        int64_t mem_available = 0;
+        int64_t mem_used = 0;
+        double mem_usage = 0;
+        int64_t swap_used = 0;
+        double swap_usage = 0;
+        int64_t cached = 0;
+        int64_t dirty = 0;
+        int64_t writeback = 0;
+        double major_faults = 0;
+        double pressure_some_avg10 = 0;
+        double pressure_some_avg60 = 0;
+        double pressure_full_avg10 = 0;
+        double pressure_full_avg60 = 0;
+
+        MemInfo() : Message(Type::MEM_INFO) {}
+    };
+    MESSAGE_DEFINE_TYPE(MemInfo,
+                        type,
+                        mem_available,
+                        mem_used,
+                        mem_usage,
+                        swap_used,
+                        swap_usage,
+                        cached,
+                        dirty,
+                        writeback,
+                        major_faults,
+                        pressure_some_avg10,
+                        pressure_some_avg60,
+                        pressure_full_avg10,
+                        pressure_full_avg60);
+
+    // One entry of /sys/block. size is in bytes, scheduler the active I/O scheduler
+    // ("none" for devices without one).
+    struct DiskDevice {
+        std::string name;
+        bool rotational = false;
+        int64_t size = 0;
+        std::string scheduler;
+    };
+    MESSAGE_DEFINE_TYPE(DiskDevice, name, rotational, size, scheduler);
+
+    struct DiskInfoStatic : public Message {
+        std::vector<DiskDevice> devices;
+
+        DiskInfoStatic() : Message(Type::DISK_INFO_STATIC) {}
+    };
+    MESSAGE_DEFINE_TYPE(DiskInfoStatic, type, devices);
+
+    // Rates over the last tick: operations and bytes per second, average number of
+    // requests in flight, average milliseconds per completed request, and the percent of
+    // time the device was busy
+    struct DiskStat {
+        std::string name;
+        double read_iops = 0;
+        double write_iops = 0;
+        double read_bytes = 0;
+        double write_bytes = 0;
+        double queue_depth = 0;
+        double await = 0;
+        double utilization = 0;
+    };
+    MESSAGE_DEFINE_TYPE(DiskStat,
+                        name,
+                        read_iops,
+                        write_iops,
+                        read_bytes,
+                        write_bytes,
+                        queue_depth,
+                        await,
+                        utilization);
+
+    struct DiskInfo : public Message {
+        std::vector<DiskStat> devices;
+
+        DiskInfo() : Message(Type::DISK_INFO) {}
+    };
+    MESSAGE_DEFINE_TYPE(DiskInfo, type, devices);
+
+    // Per-second rates of one interface over the last tick
+    struct NetStat {
+        std::string name;
+        double rx_bytes = 0;
+        double tx_bytes = 0;
+        double rx_packets = 0;
+        double tx_packets = 0;
+        double rx_errors = 0;
+        double tx_errors = 0;
+        double rx_dropped = 0;
+        double tx_dropped = 0;
+    };
+    MESSAGE_DEFINE_TYPE(NetStat,
+                        name,
+                        rx_bytes,
+                        tx_bytes,
+                        rx_packets,
+                        tx_packets,
+                        rx_errors,
+                        tx_errors,
+                        rx_dropped,
+                        tx_dropped);
+
+    // total is the sum over the reported interfaces
+    struct NetInfo : public Message {
+        std::vector<NetStat> interfaces;
+        NetStat total;
+
+        NetInfo() : Message(Type::NET_INFO) {}
+    };
+    MESSAGE_DEFINE_TYPE(NetInfo, type, interfaces, total);
+
+    // cpu_usage is in percent of one CPU since the previous scan, like top, rss in kB
+    struct ProcessStat {
+        int pid = 0;
+        std::string name;
+        double cpu_usage = 0;
+        int64_t rss = 0;
+        int threads = 0;
+    };
+    MESSAGE_DEFINE_TYPE(ProcessStat, pid, name, cpu_usage, rss, threads);
+
+    // The heaviest of `processes` processes by CPU and by resident memory
+    struct ProcessInfo : public Message {
+        int processes = 0;
+        std::vector<ProcessStat> top_cpu;
+        std::vector<ProcessStat> top_memory;
+
+        ProcessInfo() : Message(Type::PROCESS_INFO) {}
+    };
+    MESSAGE_DEFINE_TYPE(ProcessInfo, type, processes, top_cpu, top_memory);
 }  // namespace message
 
 // Utility functions for parsing and serializing messages
 namespace message {
 
-    using MessageVariantIN = std::variant<Error, AuthResponse>;
+    using MessageVariantIN = std::variant<Error, AuthResponse, Subscribe, HistoryRequest>;
     using MessageVariantOUT = std::variant<Error,
                                            AuthChallenge,
                                            AuthResult,
                                            SystemInfoStatic,
                                            SystemInfo,
                                            CpuInfoStatic,
-                                           CpuInfo>;
+                                           CpuInfo,
+                                           CpuHistory,
+                                           CpuRollup,
+                                           SelfStats,
+                                           MemInfoStatic,
+                                           MemInfo,
+                                           DiskInfoStatic,
+                                           DiskInfo,
+                                           NetInfo,
+                                           ProcessInfo>;
 
     using MessageVariant = std::variant<Error,
                                         AuthChallenge,
                                         AuthResponse,
+                                        Subscribe,
+                                        HistoryRequest,
                                         AuthResult,
                                         SystemInfoStatic,
                                         SystemInfo,
                                         CpuInfoStatic,
-                                        CpuInfo>;
+                                        CpuInfo,
+                                        CpuHistory,
+                                        CpuRollup,
+                                        SelfStats,
+                                        MemInfoStatic,
+                                        MemInfo,
+                                        DiskInfoStatic,
+                                        DiskInfo,
+                                        NetInfo,
+                                        ProcessInfo>;
 
     using ParserFn = message::MessageVariantIN (*)(const nlohmann::json&);
 
@@ -194,6 +574,14 @@ namespace message {
          [](const nlohmann::json& j) -> MessageVariantIN {
              return j.get<message::AuthResponse>();
          }},
+        {message::Type::SUBSCRIBE,
+         [](const nlohmann::json& j) -> MessageVariantIN {
+             return j.get<message::Subscribe>();
+         }},
+        {message::Type::HISTORY_REQUEST,
+         [](const nlohmann::json& j) -> MessageVariantIN {
+             return j.get<message::HistoryRequest>();
+         }},
     };
 
     inline std::optional<message::MessageVariantIN> parseMessage(
@@ -210,11 +598,61 @@ namespace message {
             return it->second(j);
         } catch (const nlohmann::json::exception& e) {
             return message::Error{e.id, e.what()};
+        } catch (const std::invalid_argument& e) {
+            // A field that parsed but holds a value the server rejects
+            return message::Error{400, e.what()};
         }
     }
 
+    // Appends the JSON text of msg to out, so callers can reuse one buffer
+    inline void serializeMessage(const message::MessageVariantOUT& msg,
+                                 std::string& out) {
+        JsonWriter writer(out);
+        std::visit([&](const auto& m) { writer.value(m); }, msg);
+    }
+
     inline std::string serializeMessage(const message::MessageVariantOUT& msg) {
-        return std::visit([](const auto& m) { return nlohmann::json(m).dump(); }, msg);
+        std::string out;
+        out.reserve(256);
+        serializeMessage(msg, out);
+        return out;
+    }
+
+    // JSON text with invalid UTF-8 replaced rather than thrown on, see utf8.hpp
+    inline std::string dumpJson(const nlohmann::json& j) {
+        return j.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+    }
+
+    // Reference implementation through a nlohmann::json DOM, serializeMessage() must
+    // produce the same bytes
+    inline std::string serializeMessageReference(const message::MessageVariantOUT& msg) {
+        return std::visit([](const auto& m) { return dumpJson(nlohmann::json(m)); }, msg);
+    }
+
+    // Encodes an already built JSON value in the given wire encoding
+    inline std::string serializeJson(const nlohmann::json& j, Encoding encoding) {
+        std::string out;
+        if (encoding == Encoding::MSGPACK)
+            nlohmann::json::to_msgpack(j, out);
+        else if (encoding == Encoding::CBOR)
+            nlohmann::json::to_cbor(j, out);
+        else
+            out = dumpJson(j);
+        return out;
+    }
+
+    // Encodes msg in the given wire encoding, JSON text or MessagePack/CBOR bytes
+    inline std::string serializeMessage(const message::MessageVariantOUT& msg,
+                                        Encoding encoding) {
+        if (encoding == Encoding::JSON)
+            return serializeMessage(msg);
+
+        return serializeJson(
+            std::visit([](const auto& m) { return nlohmann::json(m); }, msg), encoding);
+    }
+
+    inline message::Type getMessageType(const message::MessageVariantOUT& msg) {
+        return std::visit([](const auto& m) { return m.type; }, msg);
     }
 
     inline message::Type getMessageType(const std::string_view payload) {
@@ -0,0 +1,223 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "utf8.hpp"
+
+namespace message {
+    // Writes JSON text straight into a caller-owned string, without building a
+    // nlohmann::json DOM first. Output is byte-for-byte what nlohmann's dump() produces
+    // for the same values with error_handler_t::replace, so both paths stay
+    // interchangeable. Invalid UTF-8 in strings goes out as U+FFFD.
+    class JsonWriter {
+    public:
+        explicit JsonWriter(std::string& out) : out_(out) {}
+
+        void beginObject() {
+            separator();
+            out_ += '{';
+            needComma_ = false;
+        }
+
+        void endObject() {
+            out_ += '}';
+            needComma_ = true;
+        }
+
+        void beginArray() {
+            separator();
+            out_ += '[';
+            needComma_ = false;
+        }
+
+        void endArray() {
+            out_ += ']';
+            needComma_ = true;
+        }
+
+        template <typename T>
+        void member(std::string_view name, const T& v) {
+            separator();
+            string(name);
+            out_ += ':';
+            needComma_ = false;
+            value(v);
+        }
+
+        template <typename T>
+        void value(const T& v) {
+            separator();
+            if constexpr (std::is_same_v<T, bool>) {
+                out_ += v ? "true" : "false";
+            } else if constexpr (std::is_integral_v<T>) {
+                integer(v);
+            } else if constexpr (std::is_floating_point_v<T>) {
+                real(static_cast<double>(v));
+            } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+                string(v);
+            } else if constexpr (isVector<T>::value) {
+                beginArray();
+                for (const auto& item : v) {
+                    value(item);
+                }
+                endArray();
+            } else {
+                // Messages and enums provide writeJson() next to their definition
+                writeJson(*this, v);
+            }
+            needComma_ = true;
+        }
+
+    private:
+        template <typename T>
+        struct isVector : std::false_type {};
+        template <typename T, typename A>
+        struct isVector<std::vector<T, A>> : std::true_type {};
+
+        void separator() {
+            if (needComma_) {
+                out_ += ',';
+                needComma_ = false;
+            }
+        }
+
+        template <typename T>
+        void integer(T v) {
+            char buf[24];
+            auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), v);
+            out_.append(buf, end);
+        }
+
+        // std::to_chars gives the shortest round-trip digits, nlohmann uses Grisu2, which
+        // picks a longer digit string for ~0.1% of doubles. Call nlohmann's own
+        // allocation-free primitive so both serializers keep producing identical bytes.
+        void real(double v) {
+            if (!std::isfinite(v)) {
+                out_ += "null";
+                return;
+            }
+
+            char buf[64];
+            char* end = nlohmann::detail::to_chars(buf, buf + sizeof(buf), v);
+            out_.append(buf, end);
+        }
+
+        void string(std::string_view s) {
+            static constexpr char hex[] = "0123456789abcdef";
+
+            out_ += '"';
+            for (std::size_t i = 0; i < s.size();) {
+                const char c = s[i];
+
+                if (static_cast<unsigned char>(c) >= 0x80) {
+                    const utf8::Sequence seq = utf8::next(s.substr(i));
+                    if (seq.valid)
+                        out_.append(s.substr(i, seq.length));
+                    else
+                        out_ += utf8::kReplacement;
+                    i += seq.length;
+                    continue;
+                }
+
+                ++i;
+                switch (c) {
+                    case '"':
+                        out_ += "\\\"";
+                        break;
+                    case '\\':
+                        out_ += "\\\\";
+                        break;
+                    case '\b':
+                        out_ += "\\b";
+                        break;
+                    case '\f':
+                        out_ += "\\f";
+                        break;
+                    case '\n':
+                        out_ += "\\n";
+                        break;
+                    case '\r':
+                        out_ += "\\r";
+                        break;
+                    case '\t':
+                        out_ += "\\t";
+                        break;
+                    default:
+                        if (static_cast<unsigned char>(c) < 0x20) {
+                            out_ += "\\u00";
+                            out_ += hex[(c >> 4) & 0xF];
+                            out_ += hex[c & 0xF];
+                        } else {
+                            out_ += c;
+                        }
+                }
+            }
+            out_ += '"';
+        }
+
+        std::string& out_;
+        bool needComma_ = false;
+    };
+
+    namespace detail {
+        template <typename T>
+        struct FieldWriter {
+            std::string_view name;
+            void (*write)(JsonWriter&, const T&);
+        };
+
+        // nlohmann::json objects are std::map backed, so dump() emits keys sorted.
+        // Sorting the field table at compile time keeps both serializers identical.
+        template <typename T, std::size_t N>
+        constexpr std::array<std::size_t, N> sortedOrder(
+            const FieldWriter<T> (&fields)[N]) {
+            std::array<std::size_t, N> order{};
+            for (std::size_t i = 0; i < N; ++i) {
+                order[i] = i;
+            }
+            std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+                return fields[a].name < fields[b].name;
+            });
+            return order;
+        }
+    }  // namespace detail
+}  // namespace message
+
+#define MESSAGE_JSON_FIELD(v1)                                                   \
+    ::message::detail::FieldWriter<Self>{                                        \
+        #v1, [](::message::JsonWriter& w, const Self& o) { w.member(#v1, o.v1); }},
+
+#define MESSAGE_DEFINE_WRITER(Type, ...)                                              \
+    inline void writeJson(::message::JsonWriter& writer, const Type& obj) {         \
+        using Self = Type;                                                           \
+        static constexpr ::message::detail::FieldWriter<Self> fields[] = {           \
+            NLOHMANN_JSON_EXPAND(NLOHMANN_JSON_PASTE(MESSAGE_JSON_FIELD, __VA_ARGS__))}; \
+        static constexpr auto order = ::message::detail::sortedOrder(fields);        \
+        writer.beginObject();                                                        \
+        for (std::size_t i : order) {                                                \
+            fields[i].write(writer, obj);                                            \
+        }                                                                            \
+        writer.endObject();                                                          \
+    }
+
+// Drop-in replacement for NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE. Keeps the nlohmann
+// to_json/from_json pair and generates a writeJson() for JsonWriter from the same
+// field list.
+#define MESSAGE_DEFINE_TYPE(Type, ...)                     \
+    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Type, __VA_ARGS__) \
+    MESSAGE_DEFINE_WRITER(Type, __VA_ARGS__)
+
+// Same, but fields missing from parsed input keep their default value
+#define MESSAGE_DEFINE_TYPE_WITH_DEFAULT(Type, ...)                     \
+    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(Type, __VA_ARGS__) \
+    MESSAGE_DEFINE_WRITER(Type, __VA_ARGS__)
+
+#endif  // JSON_WRITER_H
@@ -0,0 +1,76 @@
+#ifndef UTF8_H
+#define UTF8_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Text from the kernel and sysfs (comm, interface names, disk models, hostnames) is
+// whatever bytes somebody put there. WebSocket text frames must be valid UTF-8, so
+// every string goes out with invalid sequences replaced by U+FFFD.
+namespace message::utf8 {
+    inline constexpr std::string_view kReplacement = "\xef\xbf\xbd";
+
+    struct Sequence {
+        std::size_t length;
+        bool valid;
+    };
+
+    // The sequence at the front of s, which must not be empty. When it is not one
+    // well-formed code point, length covers the maximal subpart a single U+FFFD stands
+    // in for (Unicode ch. 3.9), the same bytes nlohmann's error_handler_t::replace
+    // consumes, so both serializers stay identical.
+    inline Sequence next(std::string_view s) {
+        const auto lead = static_cast<unsigned char>(s[0]);
+
+        // Length from the lead byte, and the range of the second byte that rules out
+        // overlong forms, surrogates and code points past U+10FFFF
+        std::size_t length = 0;
+        unsigned char lo = 0x80;
+        unsigned char hi = 0xbf;
+        if (lead < 0x80) {
+            return {1, true};
+        } else if (lead >= 0xc2 && lead <= 0xdf) {
+            length = 2;
+        } else if (lead >= 0xe0 && lead <= 0xef) {
+            length = 3;
+            lo = lead == 0xe0 ? 0xa0 : lo;
+            hi = lead == 0xed ? 0x9f : hi;
+        } else if (lead >= 0xf0 && lead <= 0xf4) {
+            length = 4;
+            lo = lead == 0xf0 ? 0x90 : lo;
+            hi = lead == 0xf4 ? 0x8f : hi;
+        } else {
+            return {1, false};
+        }
+
+        std::size_t valid = 1;
+        while (valid < length && valid < s.size()) {
+            const auto c = static_cast<unsigned char>(s[valid]);
+            if (c < (valid == 1 ? lo : 0x80) || c > (valid == 1 ? hi : 0xbf))
+                break;
+            ++valid;
+        }
+
+        return {valid, valid == length};
+    }
+
+    // s with every invalid or truncated sequence replaced by one U+FFFD
+    inline std::string sanitize(std::string_view s) {
+        std::string out;
+        out.reserve(s.size());
+
+        while (!s.empty()) {
+            const Sequence seq = next(s);
+            if (seq.valid)
+                out.append(s.substr(0, seq.length));
+            else
+                out.append(kReplacement);
+            s.remove_prefix(seq.length);
+        }
+
+        return out;
+    }
+}  // namespace message::utf8
+
+#endif  // UTF8_H
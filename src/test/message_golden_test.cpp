@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+#include <json.hpp>
+#include <cmath>
+#include <limits>
+#include <set>
+
+// serializeMessage() writes JSON directly, serializeMessageReference() goes through a
+// nlohmann::json DOM. Clients were written against the latter, so every outbound type
+// has to come out of both byte for byte, and match the recorded text below.
+
+namespace {
+    struct Golden {
+        message::MessageVariantOUT msg;
+        std::string_view json;
+    };
+
+    std::vector<Golden> everyOutboundType() {
+        message::CpuHistory history;
+        history.timestamps = {1718000000000, 1718000001000};
+        history.cpu_load_avg_1min = {0.52, 0.61};
+        history.cpu_load_avg_5min = {0.58, 0.58};
+        history.cpu_load_avg_15min = {0.59, 0.59};
+        history.cpu_usage = {12.5, 99.75};
+        history.per_core_usage = {{3.0, 100.0}, {21.25, 0.0}};
+        history.cpu_frequency = {2400000, 3400000};
+
+        message::CpuRollup rollup;
+        rollup.window_s = 60;
+        rollup.start = 1718000040000;
+        rollup.samples = 60;
+        rollup.cpu_load_avg_1min = {0.5, 0.75, 0.625, 0.7};
+        rollup.cpu_usage = {1.0, 98.0, 40.5, 91.25};
+        rollup.per_core_usage = {{0, 100, 50, 95}};
+
+        message::SelfStats stats;
+        stats.counters = {{"server.dropped_frames", 12}};
+        stats.histograms = {{"collect.cpu_ns", 60, 1200, 18000, 15000, 31000, 88000,
+                             18446744073709551615ULL}};
+
+        message::MemInfo mem;
+        mem.mem_available = 201837264;
+        mem.mem_used = 62010096;
+        mem.mem_usage = 23.502381;
+        mem.major_faults = 12.4;
+        mem.pressure_some_avg10 = 0.31;
+
+        message::DiskInfoStatic disksStatic;
+        disksStatic.devices = {{"nvme0n1", false, 3840755982336, "none"},
+                               {"sda", true, 4000787030016, "mq-deadline"}};
+
+        message::DiskInfo disks;
+        disks.devices = {
+            {"nvme0n1", 1204.5, 388.25, 98304000, 27721728, 1.84, 0.412, 37.5}};
+
+        message::NetInfo net;
+        net.interfaces = {{"eth0", 118734592.5, 9342976, 81234, 40117.5, 0, 0, 1.5, 0}};
+        net.total = net.interfaces[0];
+
+        message::ProcessInfo processes;
+        processes.processes = 1873;
+        processes.top_cpu = {{4211, "postgres", 98.5, 1048576, 12}};
+        processes.top_memory = {{1024, "java", 12.0, 16777216, 184}};
+
+        return {
+            {message::Error{400, "Unknown message type"},
+             R"({"code":400,"message":"Unknown message type","type":"ERROR"})"},
+            {message::AuthChallenge("6f1c2a9e0b7d4e3f"),
+             R"({"nonce":"6f1c2a9e0b7d4e3f","type":"AUTH_CHALLENGE"})"},
+            {message::AuthResult(true, "Authentication successful"),
+             R"({"reason":"Authentication successful","success":true,)"
+             R"("type":"AUTH_RESULT"})"},
+            {message::SystemInfoStatic("node-01", "Debian GNU/Linux", "12",
+                                       "6.1.0-21-amd64", "Europe/Warsaw"),
+             R"({"hostname":"node-01","kernel_version":"6.1.0-21-amd64",)"
+             R"("system_name":"Debian GNU/Linux","timezone":"Europe/Warsaw",)"
+             R"("type":"SYSTEM_INFO_STATIC","version_id":"12"})"},
+            {message::SystemInfo("12 days, 4:31:07", "2024-06-10 14:21:33"),
+             R"({"local_time":"2024-06-10 14:21:33","type":"SYSTEM_INFO",)"
+             R"("uptime":"12 days, 4:31:07"})"},
+            {message::CpuInfoStatic("Intel(R) Xeon(R) Platinum 8380 CPU @ 2.30GHz",
+                                    "x86_64", 3400000, 40, 80),
+             R"({"cpu_architecture":"x86_64","cpu_cores":40,"cpu_max_frequency":3400000,)"
+             R"("cpu_model":"Intel(R) Xeon(R) Platinum 8380 CPU @ 2.30GHz",)"
+             R"("cpu_threads":80,"type":"CPU_INFO_STATIC"})"},
+            {message::CpuInfo(1.52, 1.38, 1.21, 37.5, {0.0, 12.25, 100.0}, 2400000),
+             R"({"cpu_frequency":2400000,"cpu_load_avg_15min":1.21,)"
+             R"("cpu_load_avg_1min":1.52,"cpu_load_avg_5min":1.38,"cpu_usage":37.5,)"
+             R"("per_core_usage":[0.0,12.25,100.0],"type":"CPU_INFO"})"},
+            {history,
+             R"({"cpu_frequency":[2400000,3400000],"cpu_load_avg_15min":[0.59,0.59],)"
+             R"("cpu_load_avg_1min":[0.52,0.61],"cpu_load_avg_5min":[0.58,0.58],)"
+             R"("cpu_usage":[12.5,99.75],"per_core_usage":[[3.0,100.0],[21.25,0.0]],)"
+             R"("timestamps":[1718000000000,1718000001000],"type":"CPU_HISTORY"})"},
+            {rollup,
+             R"({"cpu_frequency":{"avg":0.0,"max":0.0,"min":0.0,"p95":0.0},)"
+             R"("cpu_load_avg_15min":{"avg":0.0,"max":0.0,"min":0.0,"p95":0.0},)"
+             R"("cpu_load_avg_1min":{"avg":0.625,"max":0.75,"min":0.5,"p95":0.7},)"
+             R"("cpu_load_avg_5min":{"avg":0.0,"max":0.0,"min":0.0,"p95":0.0},)"
+             R"("cpu_usage":{"avg":40.5,"max":98.0,"min":1.0,"p95":91.25},)"
+             R"("per_core_usage":[{"avg":50.0,"max":100.0,"min":0.0,"p95":95.0}],)"
+             R"("samples":60,"start":1718000040000,"type":"CPU_ROLLUP","window_s":60})"},
+            {stats,
+             R"({"counters":[{"name":"server.dropped_frames","value":12}],)"
+             R"("histograms":[{"count":60,"max":18446744073709551615,"mean":18000,)"
+             R"("min":1200,"name":"collect.cpu_ns","p50":15000,"p90":31000,)"
+             R"("p99":88000}],"type":"SELF_STATS"})"},
+            {message::MemInfoStatic(263847360, 8388604),
+             R"({"mem_total":263847360,"swap_total":8388604,"type":"MEM_INFO_STATIC"})"},
+            {mem,
+             R"({"cached":0,"dirty":0,"major_faults":12.4,"mem_available":201837264,)"
+             R"("mem_usage":23.502381,"mem_used":62010096,"pressure_full_avg10":0.0,)"
+             R"("pressure_full_avg60":0.0,"pressure_some_avg10":0.31,)"
+             R"("pressure_some_avg60":0.0,"swap_usage":0.0,"swap_used":0,)"
+             R"("type":"MEM_INFO","writeback":0})"},
+            {disksStatic,
+             R"({"devices":[{"name":"nvme0n1","rotational":false,"scheduler":"none",)"
+             R"("size":3840755982336},{"name":"sda","rotational":true,)"
+             R"("scheduler":"mq-deadline","size":4000787030016}],)"
+             R"("type":"DISK_INFO_STATIC"})"},
+            {disks,
+             R"({"devices":[{"await":0.412,"name":"nvme0n1","queue_depth":1.84,)"
+             R"("read_bytes":98304000.0,"read_iops":1204.5,"utilization":37.5,)"
+             R"("write_bytes":27721728.0,"write_iops":388.25}],"type":"DISK_INFO"})"},
+            {net,
+             R"({"interfaces":[{"name":"eth0","rx_bytes":118734592.5,"rx_dropped":1.5,)"
+             R"("rx_errors":0.0,"rx_packets":81234.0,"tx_bytes":9342976.0,)"
+             R"("tx_dropped":0.0,"tx_errors":0.0,"tx_packets":40117.5}],)"
+             R"("total":{"name":"eth0","rx_bytes":118734592.5,"rx_dropped":1.5,)"
+             R"("rx_errors":0.0,"rx_packets":81234.0,"tx_bytes":9342976.0,)"
+             R"("tx_dropped":0.0,"tx_errors":0.0,"tx_packets":40117.5},)"
+             R"("type":"NET_INFO"})"},
+            {processes,
+             R"({"processes":1873,"top_cpu":[{"cpu_usage":98.5,"name":"postgres",)"
+             R"("pid":4211,"rss":1048576,"threads":12}],"top_memory":[{"cpu_usage":12.0,)"
+             R"("name":"java","pid":1024,"rss":16777216,"threads":184}],)"
+             R"("type":"PROCESS_INFO"})"},
+        };
+    }
+
+    void expectGolden(const message::MessageVariantOUT& msg, std::string_view json) {
+        EXPECT_EQ(message::serializeMessage(msg), json);
+        EXPECT_EQ(message::serializeMessageReference(msg), json);
+    }
+}  // namespace
+
+TEST(MessageGolden, EveryOutboundType) {
+    std::set<std::size_t> covered;
+    for (const auto& golden : everyOutboundType()) {
+        SCOPED_TRACE(message::typeName(message::getMessageType(golden.msg)));
+        expectGolden(golden.msg, golden.json);
+        covered.insert(golden.msg.index());
+    }
+
+    // A new MessageVariantOUT alternative needs an entry in everyOutboundType()
+    EXPECT_EQ(covered.size(), std::variant_size_v<message::MessageVariantOUT>);
+}
+
+TEST(MessageGolden, EdgeDoubles) {
+    // Signed zero, shortest round trip, exponent forms, subnormals, the extremes, and
+    // non-finite values, which nlohmann writes as null
+    const std::vector<double> values = {0.0,
+                                        -0.0,
+                                        0.1,
+                                        0.30000000000000004,
+                                        1e-7,
+                                        100.0,
+                                        1e16,
+                                        1e300,
+                                        5e-324,
+                                        2.2250738585072014e-308,
+                                        1.7976931348623157e308,
+                                        -123.456,
+                                        std::nan(""),
+                                        std::numeric_limits<double>::infinity(),
+                                        -std::numeric_limits<double>::infinity()};
+
+    expectGolden(message::CpuInfo(0, 0, 0, 0, values, 0),
+                 R"({"cpu_frequency":0,"cpu_load_avg_15min":0.0,"cpu_load_avg_1min":0.0,)"
+                 R"("cpu_load_avg_5min":0.0,"cpu_usage":0.0,"per_core_usage":[0.0,-0.0,)"
+                 R"(0.1,0.30000000000000004,1e-07,100.0,1e+16,1e+300,5e-324,)"
+                 R"(2.2250738585072014e-308,1.7976931348623157e+308,-123.456,null,null,)"
+                 R"(null],"type":"CPU_INFO"})");
+}
+
+TEST(MessageGolden, StringEscapes) {
+    // Quote, backslash and the short escapes, every other control byte as \u00XX, DEL
+    // and '/' untouched, and multibyte UTF-8 passed through as-is
+    std::string text = "quote\" backslash\\ slash/ \b\f\n\r\t";
+    for (char c = 0x01; c < 0x20; ++c) {
+        text += c;
+    }
+    text += "\x7f za\u017c\u00f3\u0142\u0107 \u65e5\u672c \U0001F600";
+
+    expectGolden(message::Error(-1, text),
+                 R"({"code":-1,"message":"quote\" backslash\\ slash/ \b\f\n\r\t)"
+                 R"(\u0001\u0002\u0003\u0004\u0005\u0006\u0007\b\t\n\u000b\f\r)"
+                 R"(\u000e\u000f\u0010\u0011\u0012\u0013\u0014\u0015\u0016\u0017)"
+                 R"(\u0018\u0019\u001a\u001b\u001c\u001d\u001e\u001f)"
+                 "\x7f za\u017c\u00f3\u0142\u0107 \u65e5\u672c \U0001F600"
+                 R"(","type":"ERROR"})");
+}
+
+TEST(MessageGolden, InvalidUtf8) {
+    // Names from the kernel and sysfs are arbitrary bytes. Each invalid sequence (a
+    // stray byte, an overlong form, a surrogate, past U+10FFFF, one cut short by the
+    // next character or by the end of the string) becomes one U+FFFD per maximal
+    // subpart, as in nlohmann's error_handler_t::replace
+    const std::string name =
+        "eth\xff" "0 \xc0\xaf \xed\xa0\x80 \xf4\x90\x80\x80 \xe6\x97x \xe5\xad";
+
+    expectGolden(message::Error(-1, name),
+                 "{\"code\":-1,\"message\":\"eth\uFFFD0 \uFFFD\uFFFD \uFFFD\uFFFD\uFFFD "
+                 "\uFFFD\uFFFD\uFFFD\uFFFD \uFFFDx \uFFFD\",\"type\":\"ERROR\"}");
+}
@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+#include <json.hpp>
+
+namespace {
+    message::MessageVariantIN parse(std::string_view payload) {
+        std::optional<message::MessageVariantIN> msg = message::parseMessage(payload);
+        EXPECT_TRUE(msg.has_value());
+        return msg.value_or(message::Error{});
+    }
+}  // namespace
+
+TEST(MessageParse, AuthResponseDefaults) {
+    auto msg = parse(R"({"type":"AUTH_RESPONSE","hmac":"admin_0123"})");
+    ASSERT_TRUE(std::holds_alternative<message::AuthResponse>(msg));
+
+    const auto& auth = std::get<message::AuthResponse>(msg);
+    EXPECT_EQ(auth.hmac, "admin_0123");
+    EXPECT_EQ(auth.encoding, message::Encoding::JSON);
+    EXPECT_FALSE(auth.delta);
+}
+
+TEST(MessageParse, AuthResponseEncoding) {
+    auto msg =
+        parse(R"({"type":"AUTH_RESPONSE","hmac":"a_b","encoding":"cbor","delta":true})");
+    ASSERT_TRUE(std::holds_alternative<message::AuthResponse>(msg));
+    EXPECT_EQ(std::get<message::AuthResponse>(msg).encoding, message::Encoding::CBOR);
+    EXPECT_TRUE(std::get<message::AuthResponse>(msg).delta);
+}
+
+TEST(MessageParse, AuthResponseUnknownEncoding) {
+    auto msg = parse(R"({"type":"AUTH_RESPONSE","hmac":"a_b","encoding":"msgpak"})");
+    ASSERT_TRUE(std::holds_alternative<message::Error>(msg));
+    EXPECT_EQ(std::get<message::Error>(msg).code, 400);
+}
+
+TEST(MessageParse, AuthResponseRequiresHmac) {
+    auto msg = parse(R"({"type":"AUTH_RESPONSE","encoding":"json"})");
+    EXPECT_TRUE(std::holds_alternative<message::Error>(msg));
+}
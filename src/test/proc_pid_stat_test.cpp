@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include <proc_pid_stat.h>
+#include <string>
+
+namespace {
+    // Fields 3..24 of a /proc/[pid]/stat line after "pid (comm)"
+    constexpr std::string_view kTail =
+        " S 1 1234 1234 0 -1 4194560 100 0 0 0 250 50 0 0 20 0 3 0 5000 123456789 2048"
+        " 0 18446744073709551615 1 1 0 0 0 0 0 0 0 0 0 17 3 0 0 0 0 0\n";
+
+    PidStat parse(std::string_view comm) {
+        const std::string line = "1234 (" + std::string(comm) + ")" + std::string(kTail);
+        PidStat stat{};
+        EXPECT_TRUE(procpid::parseStat(line, stat));
+        return stat;
+    }
+}  // namespace
+
+TEST(ProcPidStat, Fields) {
+    PidStat stat = parse("nodewatcher");
+    EXPECT_STREQ(stat.comm, "nodewatcher");
+    EXPECT_EQ(stat.state, 'S');
+    EXPECT_EQ(stat.utime, 250u);
+    EXPECT_EQ(stat.stime, 50u);
+    EXPECT_EQ(stat.threads, 3);
+    EXPECT_EQ(stat.starttime, 5000u);
+    EXPECT_EQ(stat.rss, 2048);
+}
+
+TEST(ProcPidStat, CommWithParentheses) {
+    PidStat stat = parse("a) S (b");
+    EXPECT_STREQ(stat.comm, "a) S (b");
+    EXPECT_EQ(stat.rss, 2048);
+}
+
+TEST(ProcPidStat, TruncatedMultibyteComm) {
+    // The kernel keeps 15 bytes of "a日本語漢字" and cuts 字 after its second byte
+    PidStat stat = parse("a日本語漢\xe5\xad");
+    EXPECT_EQ(std::string_view(stat.comm), "a日本語漢\xe5\xad");
+    EXPECT_EQ(procpid::sanitizeComm(stat.comm), "a日本語漢�");
+}
+
+TEST(ProcPidStat, SanitizeComm) {
+    EXPECT_EQ(procpid::sanitizeComm("kworker/0:1H"), "kworker/0:1H");
+    EXPECT_EQ(procpid::sanitizeComm("café \U0001f600"), "café \U0001f600");
+    EXPECT_EQ(procpid::sanitizeComm("a\xffz"), "a�z");
+    // Overlong '/', a surrogate and a code point past U+10FFFF are never valid
+    EXPECT_EQ(procpid::sanitizeComm("\xc0\xaf"), "��");
+    EXPECT_EQ(procpid::sanitizeComm("\xed\xa0\x80"), "���");
+    EXPECT_EQ(procpid::sanitizeComm("\xf4\x90\x80\x80"), "����");
+    // A sequence cut short by the next character is one replacement
+    EXPECT_EQ(procpid::sanitizeComm("\xe6\x97x"), "�x");
+}